@@ -0,0 +1,39 @@
+#pragma once
+
+// Retry/delay policy learned from shove outcomes. For each (target race, aggressor kind)
+// the table counts how often the n-th ApplyCurrent attempt, and the n-th effectiveness
+// reapply, actually took. Attempts that almost never help are trimmed off the end of the
+// chain, and a key whose first attempt keeps failing but whose retries rescue it waits a
+// frame longer before the first one. Every decision stays inside the Settings bounds.
+// Game-free and main-thread only, apart from FormatTable.
+
+#include <Knockback/Settings.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Knockback::Adaptive
+{
+    struct Key
+    {
+        std::uint32_t race{ 0 };   // ActorState::race of the target
+        bool player{ false };      // aggressor is the player
+    };
+
+    // Decisions. With adaptiveRetries off they return the configured values.
+    std::int32_t ShoveTries(const Settings& cfg, const Key& key);
+    std::int32_t InitialDelayFrames(const Settings& cfg, const Key& key);
+    // Effectiveness checks to queue after attempt `attempt` took with `remaining` tries left.
+    // The checks get the budget the chain would have had untrimmed, then lose the tail
+    // reapplies that never help; 0 when no reapply ever does.
+    std::int32_t EffectTries(const Settings& cfg, const Key& key, std::int32_t remaining, std::int32_t attempt);
+
+    // Outcomes. attempt is 1-based; reapplies counts the reapplies made before this check.
+    void RecordShove(const Key& key, std::int32_t attempt, bool ok);
+    void RecordEffect(const Key& key, std::int32_t reapplies, bool ok);
+
+    std::size_t KeyCount();
+
+    // The learned table as text, one line per key. Safe from any thread.
+    std::string FormatTable();
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+// Attack state per actor, fed by attack start/end events (IAttackEventSource, World.h)
+// instead of polling IWorld::IsAttacking every frame. A hit on an actor that is mid-attack
+// waits for the attack to finish; with events, its deferral job is parked here and handed
+// back when the actor's attack-end event arrives or its deadline passes. Actors the source
+// cannot watch, or worlds without a source, keep the per-frame poll (Tasks.cpp).
+// Game-free; main thread (scheduler tick) only.
+
+#include <Knockback/Scheduler.h>
+#include <Knockback/World.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Knockback::Attacks
+{
+    enum class State : std::uint8_t
+    {
+        kUnwatched,   // no events for this actor; poll IWorld::IsAttacking
+        kIdle,
+        kAttacking
+    };
+
+    // The first query for an actor starts watching it and seeds its state with one
+    // IWorld::IsAttacking read; after that events keep it current.
+    State Query(IWorld& world, ActorId id, std::uint64_t frame);
+
+    // Holds a deferral (and the chain reference it carries) until job.target's attack ends,
+    // or until deadline. The target must have just queried kAttacking.
+    void Park(const Job& job, std::uint64_t deadline);
+
+    // Start of a tick: applies the source's events and appends the parked deferrals that
+    // may go on to woken.
+    void BeginTick(IWorld& world, std::uint64_t frame, std::vector<Job>& woken);
+
+    // The scheduler keeps ticking while this is non-zero.
+    std::size_t ParkedCount();
+    std::size_t WatchedCount();
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <Knockback/BinLogFormat.h>
+
+#if !defined(KNOCKBACK_HEADLESS)
+#include "SKSE/SKSE.h"
+#endif
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+#include <type_traits>
+
+namespace Knockback::BinLog
+{
+    // Starts the background writer; trace calls go to the ring from now on.
+    bool Start(const std::filesystem::path& path);
+    // Drains what is queued, stops the writer and closes the file.
+    void Stop();
+
+    // Acquire pairs with the release in Start, so a producer that sees it set also sees the
+    // writer's file and format state published before it.
+    extern std::atomic_bool g_enabled;
+    inline bool IsEnabled() { return g_enabled.load(std::memory_order_acquire); }
+
+    // Stable id for a format string literal (one lookup per call site, see KB_TRACE).
+    std::uint16_t InternFormat(std::string_view fmt);
+
+    void Push(Record record);
+
+    template <class T>
+    void EncodeArg(Record& r, std::size_t i, T v)
+    {
+        using U = std::remove_cvref_t<T>;
+        if constexpr (std::is_same_v<U, bool>) {
+            r.tags[i] = ArgTag::kBool;
+            r.args[i] = v ? 1 : 0;
+        }
+        else if constexpr (std::is_same_v<U, float>) {
+            std::uint32_t bits = 0;
+            std::memcpy(&bits, &v, sizeof(bits));
+            r.tags[i] = ArgTag::kF32;
+            r.args[i] = bits;
+        }
+        else if constexpr (std::is_floating_point_v<U>) {
+            const double d = static_cast<double>(v);
+            std::memcpy(&r.args[i], &d, sizeof(d));
+            r.tags[i] = ArgTag::kF64;
+        }
+        else if constexpr (std::is_enum_v<U>) {
+            EncodeArg(r, i, static_cast<std::underlying_type_t<U>>(v));
+        }
+        else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+            r.tags[i] = ArgTag::kI64;
+            r.args[i] = static_cast<std::uint64_t>(static_cast<std::int64_t>(v));
+        }
+        else if constexpr (std::is_integral_v<U>) {
+            r.tags[i] = ArgTag::kU64;
+            r.args[i] = static_cast<std::uint64_t>(v);
+        }
+        else {
+            static_assert(std::is_arithmetic_v<U>, "binary trace only takes bool/integer/float arguments");
+        }
+    }
+
+    template <class... Args>
+    void Write(std::uint16_t formatId, const Args&... args)
+    {
+        static_assert(sizeof...(Args) <= kMaxArgs, "too many trace arguments");
+
+        Record r{};
+        r.formatId = formatId;
+        r.argc = static_cast<std::uint8_t>(sizeof...(Args));
+
+        std::size_t i = 0;
+        (EncodeArg(r, i++, args), ...);
+
+        Push(r);
+    }
+}
+
+// Text fallback for KB_TRACE. Headless builds (tools/) have no spdlog and drop it.
+#if defined(KNOCKBACK_HEADLESS)
+#define KB_TEXT_TRACE(fmt, ...) ((void)0)
+#else
+#define KB_TEXT_TRACE(fmt, ...) ::SKSE::log::trace(fmt __VA_OPT__(, ) __VA_ARGS__)
+#endif
+
+// Trace with a compile-time format string. With the binary backend enabled this costs
+// a record copy into the ring; otherwise it is a plain logger::trace.
+#define KB_TRACE(fmt, ...)                                                                    \
+    do {                                                                                      \
+        if (::Knockback::BinLog::IsEnabled()) {                                               \
+            static const std::uint16_t kbTraceFormatId = ::Knockback::BinLog::InternFormat(fmt); \
+            ::Knockback::BinLog::Write(kbTraceFormatId __VA_OPT__(, ) __VA_ARGS__);           \
+        }                                                                                     \
+        else {                                                                                \
+            KB_TEXT_TRACE(fmt __VA_OPT__(, ) __VA_ARGS__);                                    \
+        }                                                                                     \
+    } while (false)
@@ -0,0 +1,53 @@
+#pragma once
+
+// On-disk layout of the binary trace log. Shared by the plugin and the offline decoder,
+// so keep this header free of game/SKSE includes.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Knockback::BinLog
+{
+    inline constexpr std::uint32_t kFileMagic = 0x474C424B;  // "KBLG"
+    inline constexpr std::uint16_t kFileVersion = 1;
+    inline constexpr std::size_t kMaxArgs = 8;
+
+    // File = FileHeader, then a stream of chunks, each introduced by one ChunkTag byte.
+    enum class ChunkTag : std::uint8_t
+    {
+        kFormat = 'F',   // u16 id, u16 length, then length bytes of format string
+        kRecord = 'R',   // one Record
+        kDropped = 'D'   // u64 count of records lost to a full ring
+    };
+
+    enum class ArgTag : std::uint8_t
+    {
+        kNone,
+        kBool,
+        kI64,
+        kU64,
+        kF32,
+        kF64
+    };
+
+    struct FileHeader
+    {
+        std::uint32_t magic{ kFileMagic };
+        std::uint16_t version{ kFileVersion };
+        std::uint16_t recordSize{ 0 };
+    };
+
+    // One trace line: format id plus raw argument bits. Rendering happens offline.
+    struct Record
+    {
+        std::uint64_t timestampNs{ 0 };   // system_clock, since epoch
+        std::uint32_t threadIndex{ 0 };
+        std::uint16_t formatId{ 0 };
+        std::uint8_t argc{ 0 };
+        std::uint8_t reserved{ 0 };
+        ArgTag tags[kMaxArgs]{};
+        std::uint64_t args[kMaxArgs]{};
+    };
+
+    static_assert(sizeof(Record) == 88, "Record layout is part of the file format");
+}
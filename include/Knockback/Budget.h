@@ -0,0 +1,35 @@
+#pragma once
+
+// Per-frame cap on scheduled work and the watchdog that degrades the plugin when the cap
+// keeps being hit. The tick runs its shove/effectiveness jobs in priority order (player
+// involved, then nearest the camera, then freshest hit) until the job count or the
+// measured time budget is spent; the rest waits a frame or is dropped (Tasks.cpp). If the
+// budget is overrun tick after tick, whole kinds of work are switched off one level at a
+// time, and switched back on once ticks fit again. Game-free; main thread only.
+
+#include <Knockback/Settings.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace Knockback::Budget
+{
+    enum class Level : std::uint8_t
+    {
+        kFull,              // everything runs
+        kNoEffectiveness,   // effectiveness checks are skipped
+        kNoSeparation,      // ... and separation pairs
+        kPlayerOnly         // ... and shoves where neither side is the player
+    };
+
+    // A shove over budget waits at most this many frames before it is dropped.
+    constexpr std::uint8_t kMaxDeferrals = 3;
+
+    // Either budget is set.
+    bool Enabled(const Settings& cfg);
+
+    Level CurrentLevel();
+    inline bool Allows(Level least) { return CurrentLevel() < least; }
+
+    // Watchdog input, once per tick: what the tick cost and how many jobs it put off.
+    void EndTick(const Settings& cfg, std::uint64_t micros, std::size_t overBudget);
+}
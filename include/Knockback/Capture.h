@@ -0,0 +1,102 @@
+#pragma once
+
+// Capture and replay of the core's view of the game. Recording wraps the installed IWorld
+// in a decorator that logs every read and outcome (CaptureFormat.h); ReplayWorld serves a
+// capture back to the same core code off-line and reports the first decision that differs.
+
+#include <Knockback/CaptureFormat.h>
+#include <Knockback/Tasks.h>
+#include <Knockback/World.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Knockback::Capture
+{
+    // Installs a recording decorator around inner with SetWorld. Start before the first hit
+    // is submitted: replay begins from an empty registry and scheduler.
+    bool Start(const std::filesystem::path& path, IWorld& inner);
+    // Flushes, closes the file and reinstalls the inner world.
+    void Stop();
+    bool IsActive();
+
+    // Game-side inputs the core never sees directly. Main thread only.
+    void RecordRawHit(std::uint32_t target, std::uint32_t aggressor, std::uint32_t source, std::uint32_t projectile,
+        std::uint8_t flags, std::uint64_t frame);
+    // Call right before SubmitHits(hits).
+    void RecordHits(const std::vector<HitEvent>& hits);
+    // Call right before SubmitHits(cfg, hits), with the snapshot the caller pinned.
+    void RecordHits(const std::vector<HitEvent>& hits, const Settings& cfg);
+
+    class ReplayWorld final : public IWorld, public IAttackEventSource
+    {
+    public:
+        enum class Step : std::uint8_t
+        {
+            kEnd,
+            kHits,      // LastHits() holds the batch; call SubmitHits with it
+            kTask,      // call RunNextTask
+            kRawHit,    // informational only
+            kDiverged
+        };
+
+        // Loads the whole capture. False (with Error()) if it is missing or from another build.
+        bool Open(const std::filesystem::path& path);
+
+        // Next driver event. World reads in between are consumed by the core's own calls.
+        Step Next();
+        const std::vector<HitEvent>& LastHits() const { return _hits; }
+        bool RunNextTask();
+
+        bool Diverged() const { return _diverged; }
+        // The capture stopped mid-event (file still being written, or the game crashed).
+        bool Truncated() const { return _ended; }
+        // Why Open failed, or the first divergence.
+        const std::string& Error() const { return _error; }
+        std::size_t Offset() const { return _pos; }
+
+        std::uint64_t ApplyCurrentCalls() const { return _applyCurrentCalls; }
+        std::uint64_t RawHits() const { return _rawHits; }
+        // Largest velocity/duration difference seen in a matched ApplyCurrent.
+        float MaxApplyDelta() const { return _maxApplyDelta; }
+
+        SettingsPtr AcquireSettings() override;
+        bool GetActorState(ActorId id, ActorState& out) const override;
+        bool IsAttacking(ActorId id) const override;
+        bool IsValidTarget(const Settings& settings, ActorId target) const override;
+        bool SuppressedByFirstPerson(const Settings& settings, ActorId aggressor) const override;
+        bool GetCameraPosition(Vec3& out) const override;
+        IAttackEventSource* AttackEvents() override { return this; }
+        bool ApplyCurrent(ActorId target, const Vec3& velocity, float duration) override;
+        bool AddTask(std::function<void()> fn) override;
+
+        bool Watch(ActorId id) override;
+        void Drain(std::vector<AttackEvent>& out) override;
+
+    private:
+        template <class T>
+        bool Read(T& out) const;
+        bool Expect(Tag tag, const char* what) const;
+        bool ExpectIdBool(Tag tag, ActorId id, const char* what) const;
+        void Fail(std::string msg) const;
+
+        std::vector<std::uint8_t> _data;
+        mutable std::size_t _pos{ 0 };
+        mutable std::string _error;
+        mutable bool _diverged{ false };
+        mutable bool _ended{ false };
+
+        SettingsPtr _settings;
+        std::vector<HitEvent> _hits;
+        std::deque<std::function<void()>> _tasks;
+
+        std::uint64_t _applyCurrentCalls{ 0 };
+        std::uint64_t _rawHits{ 0 };
+        float _maxApplyDelta{ 0.0f };
+    };
+}
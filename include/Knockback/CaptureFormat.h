@@ -0,0 +1,46 @@
+#pragma once
+
+// On-disk layout of a capture (KnockbackPlugin.kbcap): every input the core read from the
+// game and every outcome it produced, in call order. Shared by the plugin and the replay
+// tool, so keep this header free of game/SKSE includes.
+
+#include <cstdint>
+
+namespace Knockback::Capture
+{
+    inline constexpr std::uint32_t kFileMagic = 0x5043424B;  // "KBCP"
+    inline constexpr std::uint16_t kFileVersion = 5;
+
+    // File = FileHeader, then a stream of records, each introduced by one Tag byte.
+    // Fields are written little-endian, unpadded, in the order listed.
+    enum class Tag : std::uint8_t
+    {
+        // Driver events: what the game fed into the core.
+        kRawHit = 'W',         // u32 target, u32 aggressor, u32 source, u32 projectile, u8 flags, u64 frame
+        kHits = 'H',           // u32 count, then count x (u32 aggressor, u32 target, f32 weaponMult, u64 postedMicros)
+        kTask = 'T',           // a queued core task started running
+
+        // World reads, answered from the trace on replay.
+        kSettings = 'S',       // Settings bytes (FileHeader::settingsSize) of a snapshot not seen before
+        kSettingsSame = 's',   // same snapshot as the previous kSettings
+        kActorState = 'A',     // u32 id, u8 ok, f32 x, f32 y, f32 z, u8 dead, u8 player, u32 race
+        kAttacking = 'K',      // u32 id, u8 result
+        kValidTarget = 'V',    // u32 id, u8 result
+        kFirstPerson = 'P',    // u32 id, u8 result
+        kCamera = 'M',         // u8 ok, f32 x, f32 y, f32 z
+        kWatch = 'J',          // u32 id, u8 result (IAttackEventSource::Watch)
+        kAttackEvents = 'E',   // u32 count, then count x (u32 actor, u8 kind) (IAttackEventSource::Drain)
+
+        // Outcomes, checked on replay.
+        kApplyCurrent = 'C',   // u32 id, f32 vx, f32 vy, f32 vz, f32 duration, u8 result
+        kAddTask = 'Q'         // u8 result
+    };
+
+    struct FileHeader
+    {
+        std::uint32_t magic{ kFileMagic };
+        std::uint16_t version{ kFileVersion };
+        std::uint16_t settingsSize{ 0 };
+    };
+    static_assert(sizeof(FileHeader) == 8);
+}
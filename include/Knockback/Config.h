@@ -1,57 +1,68 @@
 #pragma once
 
 #include <RE/Skyrim.h>
+#include <Knockback/FlatMap.h>
+#include <Knockback/Settings.h>
+#include <cstddef>
 #include <cstdint>
-#include <unordered_set>
+#include <memory>
+#include <vector>
 
 namespace Knockback
 {
-    struct Config
+    // Target eligibility, precomputed per race at load
+    enum TargetFlags : std::uint8_t
     {
-        // Interpreted as "speed" for ApplyCurrent (units are game/Havok-y; tune by feel).
-        float shoveMagnitude{ 2.5f };
-        float shoveDuration{ 0.12f };
-
-        // acceptance helper (not a gameplay min)
-        float applyCurrentMinVelocity{ 4.0f };
-        float minDurationScale{ 0.15f };
+        kTargetListDenied = 1 << 0,
+        kTargetListAllowed = 1 << 1,
+        kTargetKeywordDenied = 1 << 2,
+        kTargetKeywordAllowed = 1 << 3
+    };
 
-        // Attempts to apply shove
-        std::int32_t shoveRetries{ 3 };
-        std::int32_t shoveRetryDelayFrames{ 1 };
+    // Settings plus the form tables resolved against the load order.
+    struct Config : Settings
+    {
+        // Race allow/deny lists
+        FlatSet<RE::FormID> allowRaces;
+        FlatSet<RE::FormID> denyRaces;
 
-        // Delay before first shove attempt (helps avoid same-tick controller clobber)
-        std::int32_t shoveInitialDelayFrames{ 1 };
+        // Archetype keywords, checked on actor + race when the race is on neither list
+        std::vector<RE::BGSKeyword*> denyArchetypeKeywords;   // default: ActorTypeDragon, ActorTypeGiant
+        std::vector<RE::BGSKeyword*> allowArchetypeKeywords;  // default: ActorTypeNPC, ActorTypeUndead
 
-        // If after a shove the target hasn't separated by at least this many units, reapply shove.
-        float minShoveSeparationDelta{ 8.0f };
+        // Per-race verdicts (BuildTargetTables)
+        FlatMap<RE::FormID, std::uint8_t> raceTargetFlags;
 
-        // POV option: suppress when player aggressor in first-person
-        bool disableInFirstPerson{ true };
+        // WeaponType magnitude multipliers (keyword -> multiplier)
+        FlatMap<RE::BGSKeyword*, float> weaponTypeKeywordMultipliers;
 
-        // Race allow/deny lists
-        std::unordered_set<RE::FormID> allowRaces;
-        std::unordered_set<RE::FormID> denyRaces;
-
-        // Separation enforcement (player aggressor only)
-        bool enforceMinSeparation{ true };
-        float minSeparationDistance{ 110.0f };
-        float separationPushDuration{ 0.10f };
-        float separationMaxVelocity{ 10.0f };
-        std::int32_t separationRetries{ 6 };
-        std::int32_t separationInitialDelayFrames{ 1 };
-        std::int32_t separationRetryDelayFrames{ 1 };
-
-        // WeaponType magnitude multipliers
-        std::unordered_map<RE::FormID, float> weaponTypeMultipliers;
-		std::unordered_map<RE::BGSKeyword*, float> weaponTypeKeywordMultipliers;
-		float unarmedMultiplier{ 0.85f };
-		float powerAttackMultiplier{ 1.2f };
         bool HasAllowList() const { return !allowRaces.empty(); }
+
+        // Heap bytes held by the lookup tables (reported per snapshot)
+        std::size_t MemoryFootprint() const
+        {
+            return allowRaces.memory_bytes() + denyRaces.memory_bytes() +
+                   raceTargetFlags.memory_bytes() + weaponTypeKeywordMultipliers.memory_bytes() +
+                   (allowArchetypeKeywords.capacity() + denyArchetypeKeywords.capacity()) * sizeof(RE::BGSKeyword*);
+        }
     };
 
+    using ConfigPtr = std::shared_ptr<const Config>;
+
     // Accessors
-    const Config& GetConfig();
+    // Current snapshot, pinned: it stays alive for as long as the caller holds the pointer,
+    // however many reloads are published meanwhile.
+    ConfigPtr AcquireConfig();
+    std::uint64_t GetConfigEpoch();
+
+    // Startup is split in two. BeginConfigLoad (at plugin load) reads, parses and seeds the
+    // INI files on a worker thread; the first LoadConfig (kDataLoaded) joins it and only
+    // resolves forms on the main thread. Later LoadConfig calls do both halves inline.
+    void BeginConfigLoad();
     void LoadConfig();
-    void MaybeReloadConfig();
+
+    // Background file watcher: when either INI changes it parses them on its own thread and
+    // queues the resolve and publish to the main thread, the same split as startup.
+    void StartConfigWatcher();
+    void StopConfigWatcher();
 }
@@ -0,0 +1,30 @@
+#pragma once
+
+// Binary cache of the fully resolved Config (FormSpecs already turned into FormIDs),
+// stamped with a fingerprint of the INI bytes and the plugin load order. A matching
+// cache lets LoadConfig skip FormSpec resolution entirely.
+
+#include <RE/Skyrim.h>
+#include <Knockback/Config.h>
+#include <cstdint>
+#include <filesystem>
+#include <initializer_list>
+#include <string_view>
+#include <vector>
+
+namespace Knockback::ConfigCache
+{
+    // The cache fingerprint is built in two steps. HashInputs covers the INI bytes that were
+    // parsed (not a second read of the files, which may have changed since) and the cache
+    // layout and plugin versions; it needs no game data. A missing file is passed as empty,
+    // so creating one changes it. WithLoadOrder then adds the plugin load order.
+    std::uint64_t HashInputs(std::initializer_list<std::string_view> inputs);
+    std::uint64_t WithLoadOrder(std::uint64_t inputsHash);
+
+    // Maps the cache and fills out on a fingerprint match. Keywords are re-resolved by
+    // FormID; any miss, corruption or form that no longer resolves returns false.
+    bool TryLoad(const std::filesystem::path& cachePath, std::uint64_t fingerprint, Config& out);
+
+    // Writes via a temp file + rename so a crash never leaves a half-written cache.
+    void Save(const std::filesystem::path& cachePath, std::uint64_t fingerprint, const Config& cfg);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+// Watches a handful of files from a background thread and reports settled changes.
+// No game/SKSE dependencies, so it can be exercised on any host against a temp directory.
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace Knockback
+{
+    class ConfigWatcher
+    {
+    public:
+        struct Options
+        {
+            // Upper bound between stat() sweeps when notifications are unavailable or quiet.
+            std::chrono::milliseconds pollInterval{ 1000 };
+            // A change is reported only once the files have stopped changing for this long.
+            std::chrono::milliseconds debounce{ 250 };
+            bool useNotifications{ true };
+        };
+
+        // Bit i set == files[i] appeared, disappeared, or changed timestamp/size.
+        using ChangeCallback = std::function<void(std::uint32_t changedMask)>;
+
+        ConfigWatcher(std::vector<std::filesystem::path> files, ChangeCallback onChange, Options opts);
+        ~ConfigWatcher();
+
+        ConfigWatcher(const ConfigWatcher&) = delete;
+        ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+        void Start();
+        void Stop();
+
+    private:
+        struct FileState
+        {
+            bool exists{ false };
+            std::filesystem::file_time_type writeTime{};
+            std::uintmax_t size{ 0 };
+
+            bool operator==(const FileState&) const = default;
+        };
+
+        std::vector<FileState> Snapshot() const;
+        std::uint32_t Diff(const std::vector<FileState>& a, const std::vector<FileState>& b) const;
+        void Run(std::stop_token stop);
+
+        std::vector<std::filesystem::path> _files;
+        ChangeCallback _onChange;
+        Options _opts;
+        std::jthread _thread;
+    };
+}
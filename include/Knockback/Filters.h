@@ -1,19 +1,23 @@
 #pragma once
 
 #include <RE/Skyrim.h>
+#include <Knockback/Config.h>
 
 namespace Knockback
 {
-    void InitKeywords();
+    // Precomputes per-race target verdicts into cfg (needs TESDataHandler).
+    void BuildTargetTables(Config& cfg);
 
     bool IsPlayer(RE::Actor* a);
-    bool ShouldDisableDueToFirstPerson(RE::Actor* aggressor);
+    bool ShouldDisableDueToFirstPerson(const Config& cfg, RE::Actor* aggressor);
 
-    bool IsValidKnockbackTarget(const RE::Actor* target);
+    bool IsValidKnockbackTarget(const Config& cfg, const RE::Actor* target);
+
+    // Cached per weapon form, invalidated when cfg.epoch changes. Hits and misses are
+    // counted as weaponCache.hit / weaponCache.miss.
+    float GetWeaponMultiplier(const Config& cfg, const RE::TESObjectWEAP* weap);
 
-    float GetWeaponMultiplier(const RE::TESObjectWEAP* weap);
     bool IsMeleeWeapon(const RE::TESObjectWEAP* weap);
     bool IsMagicSource(RE::FormID sourceID);
-    const RE::TESObjectWEAP* ResolveWeaponFromEventOrEquipped(const RE::TESHitEvent& evt, RE::Actor* aggressor);
     bool GetIsAttacking(RE::Actor* a);
 }
@@ -0,0 +1,93 @@
+#pragma once
+
+// Build-once, read-many containers for config data: one sorted contiguous array each,
+// binary-searched on lookup. Construct from an unsorted vector; there is no insert.
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace Knockback
+{
+    template <class K>
+    class FlatSet
+    {
+    public:
+        using value_type = K;
+        using const_iterator = typename std::vector<K>::const_iterator;
+
+        FlatSet() = default;
+
+        explicit FlatSet(std::vector<K> keys) :
+            _keys(std::move(keys))
+        {
+            std::sort(_keys.begin(), _keys.end());
+            _keys.erase(std::unique(_keys.begin(), _keys.end()), _keys.end());
+            _keys.shrink_to_fit();
+        }
+
+        [[nodiscard]] bool contains(const K& key) const
+        {
+            return std::binary_search(_keys.begin(), _keys.end(), key);
+        }
+
+        [[nodiscard]] bool empty() const { return _keys.empty(); }
+        [[nodiscard]] std::size_t size() const { return _keys.size(); }
+        [[nodiscard]] const_iterator begin() const { return _keys.begin(); }
+        [[nodiscard]] const_iterator end() const { return _keys.end(); }
+
+        [[nodiscard]] std::size_t memory_bytes() const { return _keys.capacity() * sizeof(K); }
+
+    private:
+        std::vector<K> _keys;
+    };
+
+    template <class K, class V>
+    class FlatMap
+    {
+    public:
+        using value_type = std::pair<K, V>;
+        using const_iterator = typename std::vector<value_type>::const_iterator;
+
+        FlatMap() = default;
+
+        // Duplicate keys: the last one in input order wins, like repeated operator[] assignment.
+        explicit FlatMap(std::vector<value_type> entries)
+        {
+            std::stable_sort(entries.begin(), entries.end(),
+                [](const value_type& a, const value_type& b) { return a.first < b.first; });
+
+            _entries.reserve(entries.size());
+            for (auto& e : entries) {
+                if (!_entries.empty() && !(_entries.back().first < e.first)) {
+                    _entries.back().second = std::move(e.second);
+                }
+                else {
+                    _entries.push_back(std::move(e));
+                }
+            }
+            _entries.shrink_to_fit();
+        }
+
+        [[nodiscard]] const V* find(const K& key) const
+        {
+            const auto it = std::lower_bound(_entries.begin(), _entries.end(), key,
+                [](const value_type& e, const K& k) { return e.first < k; });
+            return (it != _entries.end() && !(key < it->first)) ? std::addressof(it->second) : nullptr;
+        }
+
+        [[nodiscard]] bool contains(const K& key) const { return find(key) != nullptr; }
+
+        [[nodiscard]] bool empty() const { return _entries.empty(); }
+        [[nodiscard]] std::size_t size() const { return _entries.size(); }
+        [[nodiscard]] const_iterator begin() const { return _entries.begin(); }
+        [[nodiscard]] const_iterator end() const { return _entries.end(); }
+
+        [[nodiscard]] std::size_t memory_bytes() const { return _entries.capacity() * sizeof(value_type); }
+
+    private:
+        std::vector<value_type> _entries;
+    };
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+// FormSpecs ("Skyrim.esm|0x013746") collected while the INI is read and resolved in one
+// batch afterwards. Plugin names are interned as entries are added, so each distinct plugin
+// is looked up in the load order once however many lines name it, and every FormID is then
+// computed from its plugin's slot. Entries that fail come back in one summary instead of a
+// warning per line. Game-free: the load order is reached through IPluginTable.
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Knockback::FormSpecs
+{
+    // Where a loaded plugin sits in the load order.
+    struct PluginSlot
+    {
+        std::uint16_t index{ 0 };   // compile index; the light index for an ESL
+        bool light{ false };
+    };
+
+    class IPluginTable
+    {
+    public:
+        virtual ~IPluginTable() = default;
+        // Loaded plugin by file name (case-insensitive); nullopt if it is not active.
+        virtual std::optional<PluginSlot> Find(std::string_view name) const = 0;
+    };
+
+    // Full FormID of a plugin-local ID. The local ID is masked to what the plugin type can
+    // address, so a spec written with a load-order prefix still lands in its own plugin.
+    constexpr std::uint32_t ToFormID(PluginSlot slot, std::uint32_t localID)
+    {
+        return slot.light ? 0xFE000000u | (std::uint32_t{ slot.index } << 12) | (localID & 0xFFFu) :
+                            (std::uint32_t{ slot.index } << 24) | (localID & 0xFFFFFFu);
+    }
+
+    class Batch
+    {
+    public:
+        using Handle = std::uint32_t;
+        static constexpr Handle kInvalid = ~Handle{ 0 };
+
+        // arena backs the entry and plugin tables and must outlive the batch. Add copies the
+        // spec text into it, so the file it came from can be closed right after.
+        explicit Batch(std::pmr::memory_resource* arena);
+
+        // Parses "Plugin|HEX" (trailing ;/# comment, "FormID:" and "0x" prefixes allowed) and
+        // queues it. kInvalid if it does not parse; that is counted in the report.
+        Handle Add(std::string_view spec);
+
+        // Looks every interned plugin up once and computes all queued FormIDs.
+        void Resolve(const IPluginTable& plugins);
+
+        // After Resolve: the entry's FormID, 0 if its plugin is not loaded or h is kInvalid.
+        std::uint32_t FormID(Handle h) const;
+        // The ID resolved but names no form of the expected type; reported under its plugin.
+        void Reject(Handle h);
+
+        std::size_t Size() const { return _entries.size(); }
+        std::size_t PluginCount() const { return _plugins.size(); }
+        std::size_t UnresolvedCount() const;
+
+        // One line naming the malformed specs and, per plugin, what did not resolve; empty
+        // when everything did.
+        std::string Report() const;
+
+    private:
+        struct Entry
+        {
+            std::uint32_t plugin{ 0 };
+            std::uint32_t localID{ 0 };
+            std::uint32_t formID{ 0 };
+        };
+
+        struct Plugin
+        {
+            std::string_view name;
+            std::optional<PluginSlot> slot;
+            std::uint32_t entries{ 0 };
+            std::uint32_t rejected{ 0 };
+            std::string_view firstRejected;
+        };
+
+        struct NameHash
+        {
+            std::size_t operator()(std::string_view s) const;
+        };
+        struct NameEquals
+        {
+            bool operator()(std::string_view a, std::string_view b) const;
+        };
+
+        std::string_view Intern(std::string_view s);
+
+        std::pmr::memory_resource* _arena;
+        std::pmr::vector<Entry> _entries;
+        std::pmr::vector<Plugin> _plugins;
+        std::pmr::unordered_map<std::string_view, std::uint32_t, NameHash, NameEquals> _pluginIndex;
+        std::pmr::vector<std::string_view> _specs;   // text per entry, for Reject()
+        std::uint32_t _lastPlugin{ 0 };
+        std::uint32_t _malformed{ 0 };
+        std::string_view _firstMalformed;
+    };
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <RE/Skyrim.h>
+#include <Knockback/World.h>
+
+#include <mutex>
+#include <vector>
+
+namespace Knockback
+{
+    // IWorld over CommonLib. ActorId is the actor's native ref handle. Attack events come
+    // from the animation graphs of the actors the core watches: the sink is added to an
+    // actor's graph on Watch and queues what it hears until the next scheduler tick drains it.
+    class GameWorld final :
+        public IWorld,
+        public IAttackEventSource,
+        public RE::BSTEventSink<RE::BSAnimationGraphEvent>
+    {
+    public:
+        static GameWorld& GetSingleton();
+
+        static ActorId ToId(RE::Actor* actor);
+
+        SettingsPtr AcquireSettings() override;
+
+        bool GetActorState(ActorId id, ActorState& out) const override;
+        bool IsAttacking(ActorId id) const override;
+
+        bool IsValidTarget(const Settings& settings, ActorId target) const override;
+        bool SuppressedByFirstPerson(const Settings& settings, ActorId aggressor) const override;
+        bool GetCameraPosition(Vec3& out) const override;
+
+        bool ApplyCurrent(ActorId target, const Vec3& velocity, float duration) override;
+
+        bool AddTask(std::function<void()> fn) override;
+
+        IAttackEventSource* AttackEvents() override { return this; }
+        bool Watch(ActorId id) override;
+        void Drain(std::vector<AttackEvent>& out) override;
+
+        // Animation graph threads.
+        RE::BSEventNotifyControl ProcessEvent(
+            const RE::BSAnimationGraphEvent* event,
+            RE::BSTEventSource<RE::BSAnimationGraphEvent>* source) override;
+
+    private:
+        std::mutex _eventsMutex;
+        std::vector<AttackEvent> _events;
+        std::uint64_t _eventsDropped{ 0 };
+        std::uint64_t _reportedEventDrops{ 0 };
+    };
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <RE/Skyrim.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace Knockback
+{
+    enum RawHitFlags : std::uint8_t
+    {
+        kRawHitPowerAttack = 1 << 0
+    };
+
+    // What the event callback records for a hit: handles and ids only. Everything that
+    // needs a form lookup or the config happens later, in DrainHitInbox.
+    struct RawHit
+    {
+        RE::RefHandle target{ 0 };
+        RE::RefHandle aggressor{ 0 };
+        RE::FormID source{ 0 };
+        RE::FormID projectile{ 0 };
+        std::uint64_t frame{ 0 };   // scheduler frame when the event fired
+        std::uint64_t postedMicros{ 0 };   // Metrics::NowMicros() when the event fired
+        std::uint8_t flags{ 0 };    // RawHitFlags
+    };
+
+    // Event-callback side: constant time and never blocks. Returns false (and counts the
+    // drop) when the inbox is full. Arms one drain task per frame.
+    bool PostHit(const RawHit& hit);
+
+    // Main thread: classifies everything queued so far and submits it as one batch.
+    // Throughput and drops are reported through Metrics (hit.*, inbox.us, drain.us).
+    void DrainHitInbox();
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+// Feature flags of the hit pipeline (SubmitGatedAttack, Tasks.cpp). The pipeline is compiled
+// once per combination, with the stages of switched-off features left out, and the hit drain
+// picks the variant for each newly published snapshot; a hit on a snapshot with first-person
+// suppression, LOD, adaptive retries and degradation all off runs none of their checks.
+// Game-free.
+
+#include <Knockback/Budget.h>
+#include <Knockback/Lod.h>
+#include <Knockback/Settings.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace Knockback::HitPipeline
+{
+    using Features = std::uint8_t;
+
+    enum : Features
+    {
+        kFirstPerson = 1 << 0,   // disableInFirstPerson: ask the camera on player attacks
+        kLod = 1 << 1,           // a LOD tier is set: classify NPC-vs-NPC hits by distance
+        kAdaptive = 1 << 2,      // adaptiveRetries: tries come from the adaptive table
+        kDegrade = 1 << 3        // budget with frameBudgetDegrade: NPC-vs-NPC shoves may be shed
+    };
+
+    // Every combination has a variant.
+    constexpr std::size_t kVariants = 1 << 4;
+
+    inline Features FeaturesOf(const Settings& cfg)
+    {
+        Features f = 0;
+        if (cfg.disableInFirstPerson) f |= kFirstPerson;
+        if (Lod::Enabled(cfg)) f |= kLod;
+        if (cfg.adaptiveRetries) f |= kAdaptive;
+        if (Budget::Enabled(cfg) && cfg.frameBudgetDegrade) f |= kDegrade;
+        return f;
+    }
+}
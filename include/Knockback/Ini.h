@@ -0,0 +1,59 @@
+#pragma once
+
+// Zero-copy INI reader: one pass over a memory-mapped file into (section, key, value) views
+// of its bytes, in file order. Reads the dialect the SimpleIni calls it replaced did:
+// repeated keys kept, case-insensitive names, ';'/'#' comment lines, values that must parse
+// whole. The entry list lives in the caller's arena. Game-free.
+
+#include <Knockback/MappedFile.h>
+#include <cstdint>
+#include <filesystem>
+#include <memory_resource>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace Knockback::Ini
+{
+    struct Entry
+    {
+        std::string_view section;
+        std::string_view key;
+        std::string_view value;
+    };
+
+    class Document
+    {
+    public:
+        // arena backs the entry list and must outlive the document.
+        explicit Document(std::pmr::memory_resource* arena);
+
+        // Maps and parses path. False if it is missing or empty.
+        bool Load(const std::filesystem::path& path);
+        // Parses text the caller keeps alive.
+        void Parse(std::string_view text);
+
+        const std::pmr::vector<Entry>& Entries() const { return _entries; }
+        // The mapped bytes Load parsed; empty if it found no file.
+        std::string_view Text() const { return _file ? _file->text() : std::string_view{}; }
+        // First value of section/key, like SimpleIni's GetValue.
+        std::optional<std::string_view> Find(std::string_view section, std::string_view key) const;
+
+    private:
+        std::optional<MappedFile> _file;
+        std::pmr::vector<Entry> _entries;
+    };
+
+    bool IEquals(std::string_view a, std::string_view b);
+    std::string_view Trim(std::string_view s);
+    // Cuts a ';'/'#' comment off the end of a list item and trims what is left.
+    std::string_view StripComment(std::string_view s);
+
+    // SimpleIni's conversions: the whole value must parse, ints take a 0x prefix, bools go by
+    // their first letters (true/yes/1/on, false/no/0/off). On false out is left untouched.
+    bool ParseFloat(std::string_view s, float& out);
+    bool ParseInt(std::string_view s, std::int32_t& out);
+    bool ParseBool(std::string_view s, bool& out);
+    // Leading hex digits (the local part of a FormSpec); false if there are none.
+    bool ParseHexPrefix(std::string_view s, std::uint32_t& out);
+}
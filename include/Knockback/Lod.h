@@ -0,0 +1,33 @@
+#pragma once
+
+// Distance level of detail for hits the player is not part of. The tier is picked once,
+// from the target's distance to the camera when the hit is submitted, and travels with the
+// chain's jobs (Job::lod). Near: the full pipeline. Mid: one ApplyCurrent, no retries, no
+// effectiveness checks. Far: skipped, or with lodFarImpulse one ApplyCurrent made right
+// at the hit, without a chain or any scheduled job.
+
+#include <Knockback/Settings.h>
+#include <cstdint>
+
+namespace Knockback::Lod
+{
+    enum class Tier : std::uint8_t
+    {
+        kNear,
+        kMid,
+        kFar
+    };
+
+    inline bool Enabled(const Settings& cfg)
+    {
+        return cfg.lodMidDistance > 0.0f || cfg.lodFarDistance > 0.0f;
+    }
+
+    // distance: horizontal, target to camera. A threshold of 0 turns its tier off.
+    inline Tier Classify(const Settings& cfg, float distance)
+    {
+        if (cfg.lodFarDistance > 0.0f && distance >= cfg.lodFarDistance) return Tier::kFar;
+        if (cfg.lodMidDistance > 0.0f && distance >= cfg.lodMidDistance) return Tier::kMid;
+        return Tier::kNear;
+    }
+}
@@ -1,6 +1,18 @@
 #pragma once
 
+#include <cstdint>
+
 namespace Knockback
 {
     void SetupLog();
+
+    // Switches trace output between the text log and the async binary trace file.
+    void SetBinaryTrace(bool enabled);
+
+    // Starts, retimes or stops the periodic pipeline stats file (0 = off).
+    void SetStatsInterval(std::int32_t seconds);
+
+    // Starts the hit/outcome capture (input for tools/KnockbackReplay). Only the first config
+    // load decides: a capture has to begin before the first hit to be replayable.
+    void SetCaptureTrace(bool enabled);
 }
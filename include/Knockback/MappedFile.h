@@ -0,0 +1,37 @@
+#pragma once
+
+// Read-only memory map of a whole file. Game-free, so the INI reader and the config cache
+// share it with the offline tools.
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+namespace Knockback
+{
+    // Empty if the file is missing, empty or unreadable.
+    class MappedFile
+    {
+    public:
+        explicit MappedFile(const std::filesystem::path& path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const std::uint8_t* data() const { return _data; }
+        std::size_t size() const { return _size; }
+        std::string_view text() const { return { reinterpret_cast<const char*>(_data), _size }; }
+
+    private:
+        const std::uint8_t* _data{ nullptr };
+        std::size_t _size{ 0 };
+#if defined(_WIN32)
+        void* _file{ nullptr };      // HANDLE; kept out of the header to spare it <Windows.h>
+        void* _mapping{ nullptr };
+#else
+        int _fd{ -1 };
+#endif
+    };
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+// Pipeline counters and fixed-bucket histograms. Each thread writes its own cells
+// (a relaxed load + store, no lock prefix); readers sum over all threads. Game-free,
+// so the headless simulation reports the same numbers as the plugin.
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace Knockback::Metrics
+{
+    enum class Counter : std::uint16_t
+    {
+        // Hit inbox (event callback and drain)
+        kHitPosted,
+        kHitDropped,
+        kHitProjectile,
+        kHitMagic,
+
+        // Hit gates (SubmitHit)
+        kHitSubmitted,
+        kHitSelf,
+        kHitUnresolved,
+        kHitDead,
+        kHitFirstPerson,
+        kHitInvalidTarget,
+        kHitNoWeapon,
+
+        // Chain registry
+        kChainStarted,
+        kChainMerged,
+        kChainSuperseded,
+
+        // Scheduled jobs
+        kJobStale,
+        kJobGated,
+        kDeferralPoll,
+        kDeferralParked,         // deferral waiting on its target's attack-end event (AttackTracker.h)
+        kDeferralWoken,          // parked deferral released by the attack-end event
+        kDeferralTimedOut,       // parked deferral released by its deadline
+        kAttackEvents,           // attack start/end events applied
+        kAttackEventsDropped,    // attack events lost to a full queue (GameWorld.cpp)
+
+        kShoveApplied,
+        kShoveFailed,
+        kShoveRetry,
+        kShoveExhausted,
+
+        kEffectOk,
+        kEffectReapply,
+        kEffectReapplyFailed,
+        kEffectExhausted,
+
+        kSeparationOk,
+        kSeparationPush,
+        kSeparationPushFailed,
+        kSeparationNoProgress,
+        kSeparationExhausted,
+        kSeparationGated,        // pair dropped by its gates (actor gone, dead, first person...)
+        kSeparationMerged,       // pair pushes folded into another pair's push of the same aggressor
+
+        // Frame budget (Budget.h)
+        kBudgetDeferred,         // job over the frame budget, moved to the next frame
+        kBudgetDropped,          // job over the frame budget that was not worth waiting for
+        kDegradeSkipped,         // work switched off by the degradation level
+        kDegradeStepUp,
+        kDegradeStepDown,
+
+        // Distance LOD (Lod.h), per hit while a tier is set
+        kLodNear,
+        kLodMid,
+        kLodFar,
+        kLodFarSkipped,          // far hit dropped (LodFarImpulse off)
+        kLodImpulse,             // far hit given a one-shot ApplyCurrent (LodFarImpulse on)
+        kLodImpulseFailed,
+        kLodEffectSkipped,       // effectiveness checks not queued for a mid/far shove
+
+        // ApplyPhysicsShove refused a zero direction (actors overlap)
+        kApplyDegenerate,
+
+        // Adaptive retry policy (Adaptive.h)
+        kAdaptiveTriesCut,       // hit queued with fewer shove tries than configured
+        kAdaptiveDelayRaised,    // first shove waited longer than configured
+        kAdaptiveEffectSkipped,  // effectiveness check dropped: reapplies never help this key
+        kAdaptiveExplore,        // decision that ignored the table to keep it current
+
+        // Per-weapon multiplier cache (Filters.cpp)
+        kWeaponCacheHit,
+        kWeaponCacheMiss,        // multiplier computed: first use of the weapon this epoch
+
+        kCount
+    };
+
+    enum class Histogram : std::uint16_t
+    {
+        kInboxMicros,          // hit event -> drained on the main thread
+        kDrainMicros,          // CPU per inbox drain
+        kDeferralFrames,       // chain start -> target stopped attacking (or gave up)
+        kHitToImpulseFrames,   // chain start -> first successful ApplyCurrent
+        kHitToImpulseMicros,   // hit event -> first successful ApplyCurrent
+        kShoveAttempts,        // ApplyCurrent attempts until the shove took
+        kAttackVictims,        // hits per submitted attack (same aggressor and weapon, one drain)
+        kTickJobs,             // jobs due per scheduler tick
+        kTickMicros,           // CPU per scheduler tick (RunJobs)
+
+        kCount
+    };
+
+    // Last value wins; set once per tick from the main thread.
+    enum class Gauge : std::uint16_t
+    {
+        kJobsLive,
+        kJobsHighWater,
+        kJobPoolCapacity,
+        kJobPoolChunks,        // heap allocations the job pool has made
+        kChainsLive,
+        kChainsHighWater,
+        kAdaptiveKeys,         // (race, aggressor) entries in the adaptive table
+        kSeparationPairs,      // active separation pairs (Separation.h)
+        kSeparationPairsHighWater,
+        kDegradeLevel,         // Budget::Level, 0 = full
+        kAttackWatched,        // actors the attack tracker holds state for
+        kDeferralsParked,
+        kHitPipeline,          // HitPipeline::Features of the variant the hit drain runs
+
+        kCount
+    };
+
+    constexpr std::size_t kCounterCount = static_cast<std::size_t>(Counter::kCount);
+    constexpr std::size_t kHistogramCount = static_cast<std::size_t>(Histogram::kCount);
+    constexpr std::size_t kGaugeCount = static_cast<std::size_t>(Gauge::kCount);
+
+    // Bucket 0 holds 0; bucket k holds [2^(k-1), 2^k). The last bucket takes everything above.
+    constexpr std::size_t kBuckets = 24;
+
+    void Add(Counter counter, std::uint64_t n = 1);
+    void Record(Histogram histogram, std::uint64_t value);
+    void Set(Gauge gauge, std::uint64_t value);
+
+    // Monotonic timestamp used for all *Micros histograms.
+    std::uint64_t NowMicros();
+
+    struct HistogramSummary
+    {
+        std::uint64_t count{ 0 };
+        std::uint64_t sum{ 0 };
+        std::uint64_t max{ 0 };
+        std::array<std::uint64_t, kBuckets> buckets{};
+
+        double Mean() const { return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0; }
+        // Upper edge of the bucket holding the p-th percentile (p in [0, 1]), clamped to max.
+        std::uint64_t Percentile(double p) const;
+    };
+
+    struct Snapshot
+    {
+        std::array<std::uint64_t, kCounterCount> counters{};
+        std::array<HistogramSummary, kHistogramCount> histograms{};
+        std::array<std::uint64_t, kGaugeCount> gauges{};
+    };
+
+    // Totals since startup across every thread that has recorded anything.
+    Snapshot Collect();
+
+    std::string_view CounterName(Counter counter);
+    std::string_view HistogramName(Histogram histogram);
+    std::string_view GaugeName(Gauge gauge);
+
+    // Plain-text summary. With previous, counters also show the change since that snapshot.
+    std::string Format(const Snapshot& now, const Snapshot* previous);
+
+    // Appends a summary to path every interval from a background thread, plus one on stop.
+    // The file is truncated on start. Restarting with a new path or interval is allowed.
+    // appendix, if set, is called on the writer thread and its text follows each summary.
+    bool StartStatsWriter(const std::filesystem::path& path, std::chrono::seconds interval,
+        std::function<std::string()> appendix = {});
+    void StopStatsWriter();
+}
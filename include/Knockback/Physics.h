@@ -1,14 +1,15 @@
 #pragma once
 
-#include <RE/Skyrim.h>
+#include <Knockback/Settings.h>
+#include <Knockback/World.h>
 
 namespace Knockback
 {
-    float HorizontalDistance(RE::Actor* a, RE::Actor* b);
+    float HorizontalDistance(const Vec3& a, const Vec3& b);
 
-    void ShapeForApplyCurrent(float& mag, float& dur);
+    void ShapeForApplyCurrent(const Settings& cfg, float& mag, float& dur);
 
-    bool ApplyPhysicsShove(RE::Actor* aggressor, RE::Actor* target, float magnitude, float duration);
-
-    bool ApplyVelocityAwayFrom(RE::Actor* from, RE::Actor* who, float magnitude, float duration);
+    // Pushes target along a precomputed XY unit direction (see ShoveKernel.h).
+    // A (0, 0) direction means the actors overlap; nothing is applied.
+    bool ApplyPhysicsShove(IWorld& world, ActorId target, float dirX, float dirY, float magnitude, float duration);
 }
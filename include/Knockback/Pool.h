@@ -0,0 +1,100 @@
+#pragma once
+
+// Fixed-size records recycled through a free list. Storage grows in chunks that are never
+// given back, so once a fight has reached its peak, Acquire/Release allocate nothing.
+// Not thread-safe; the owner serializes access.
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Knockback
+{
+    struct PoolStats
+    {
+        std::size_t live{ 0 };
+        std::size_t highWater{ 0 };
+        std::size_t capacity{ 0 };
+        std::size_t chunks{ 0 };   // heap allocations made so far
+    };
+
+    template <class T, std::size_t ChunkSize = 256>
+    class SlabPool
+    {
+        static_assert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0, "chunk size must be a power of two");
+
+    public:
+        using Index = std::uint32_t;
+        static constexpr Index kNone = ~Index{ 0 };
+
+        SlabPool() = default;
+        SlabPool(const SlabPool&) = delete;
+        SlabPool& operator=(const SlabPool&) = delete;
+
+        Index Acquire()
+        {
+            if (_free == kNone) {
+                Grow();
+            }
+
+            const Index i = _free;
+            auto& node = Node(i);
+            _free = node.link;
+            node.link = kNone;
+
+            if (++_stats.live > _stats.highWater) {
+                _stats.highWater = _stats.live;
+            }
+            return i;
+        }
+
+        void Release(Index i)
+        {
+            auto& node = Node(i);
+            node.value = T{};
+            node.link = _free;
+            _free = i;
+            --_stats.live;
+        }
+
+        T& operator[](Index i) { return Node(i).value; }
+        const T& operator[](Index i) const { return Node(i).value; }
+
+        // One spare link per live record, for the owner's intrusive lists. The free list
+        // reuses it, so it is only meaningful between Acquire and Release.
+        Index& Link(Index i) { return Node(i).link; }
+
+        const PoolStats& Stats() const { return _stats; }
+
+    private:
+        struct Slot
+        {
+            T value{};
+            Index link{ kNone };
+        };
+
+        Slot& Node(Index i) { return _chunks[i / ChunkSize][i % ChunkSize]; }
+        const Slot& Node(Index i) const { return _chunks[i / ChunkSize][i % ChunkSize]; }
+
+        void Grow()
+        {
+            const auto base = static_cast<Index>(_chunks.size() * ChunkSize);
+            _chunks.push_back(std::make_unique<Slot[]>(ChunkSize));
+
+            // Thread the new chunk onto the free list in index order.
+            auto& chunk = _chunks.back();
+            for (std::size_t k = 0; k < ChunkSize; ++k) {
+                chunk[k].link = (k + 1 < ChunkSize) ? static_cast<Index>(base + k + 1) : _free;
+            }
+            _free = base;
+
+            _stats.capacity += ChunkSize;
+            ++_stats.chunks;
+        }
+
+        std::vector<std::unique_ptr<Slot[]>> _chunks;
+        Index _free{ kNone };
+        PoolStats _stats{};
+    };
+}
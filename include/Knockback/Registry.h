@@ -0,0 +1,53 @@
+#pragma once
+
+#include <Knockback/Settings.h>
+#include <Knockback/World.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace Knockback
+{
+    enum class ChainBegin : std::uint8_t
+    {
+        kStarted,     // no chain was running; caller schedules the first job
+        kUpdated,     // pending chain picked up the new aggressor/multiplier; nothing to schedule
+        kSuperseded   // running chain already shoved; its jobs are now stale, caller schedules a fresh one
+    };
+
+    // The in-flight deferral -> shove -> effectiveness chain for one target.
+    struct ShoveChain
+    {
+        ActorId aggressor{ 0 };
+        float weaponMult{ 0.0f };
+        const Settings* cfg{ nullptr };   // pinned by the registry entry for the chain's lifetime
+        std::uint32_t generation{ 0 };
+        bool shoveApplied{ false };
+        std::uint64_t startFrame{ 0 };    // scheduler frame the chain started on
+        std::uint64_t hitMicros{ 0 };     // Metrics::NowMicros() of the hit that started it
+    };
+
+    // Registers a hit against target. On kStarted/kSuperseded the first job of the new
+    // chain is already retained; schedule it with ScheduleJob directly. A new chain pins
+    // cfg; a merged hit keeps the snapshot the chain started with.
+    ChainBegin BeginShoveChain(
+        ActorId target,
+        ActorId aggressor,
+        float weaponMult,
+        SettingsPtr cfg,
+        std::uint64_t hitMicros,
+        std::uint32_t& outGeneration);
+
+    // False if the target has no chain or generation is no longer the active one.
+    bool LookupShoveChain(ActorId target, std::uint32_t generation, ShoveChain& out);
+    void MarkShoveApplied(ActorId target, std::uint32_t generation);
+    // The snapshot the chain pinned, for follow-up work that outlives the chain (separation
+    // pairs). Null if generation is no longer the active one.
+    SettingsPtr GetShoveChainSettings(ActorId target, std::uint32_t generation);
+
+    // Outstanding-job refcount; the entry is dropped when its last job finishes.
+    void RetainShoveChain(ActorId target);
+    void ReleaseShoveChain(ActorId target);
+
+    std::size_t GetActiveShoveChainCount();
+    std::size_t GetShoveChainHighWater();
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace Knockback
+{
+    // Bounded lock-free queue (Vyukov). Any number of producers, one consumer.
+    // TryPush fails instead of blocking when full; callers decide what backpressure means.
+    template <class T, std::size_t Capacity>
+    class MpscRing
+    {
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+        static_assert(std::is_trivially_copyable_v<T>, "ring entries are copied by value");
+
+    public:
+        MpscRing()
+        {
+            for (std::size_t i = 0; i < Capacity; ++i) {
+                _cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        MpscRing(const MpscRing&) = delete;
+        MpscRing& operator=(const MpscRing&) = delete;
+
+        bool TryPush(const T& value)
+        {
+            auto pos = _enqueuePos.load(std::memory_order_relaxed);
+            for (;;) {
+                auto& cell = _cells[pos & kMask];
+                const auto seq = cell.sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+
+                if (diff == 0) {
+                    if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        cell.value = value;
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0) {
+                    return false;
+                }
+                else {
+                    pos = _enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool TryPop(T& out)
+        {
+            const auto pos = _dequeuePos;
+            auto& cell = _cells[pos & kMask];
+            const auto seq = cell.sequence.load(std::memory_order_acquire);
+
+            if (static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1) < 0) {
+                return false;
+            }
+
+            out = cell.value;
+            cell.sequence.store(pos + Capacity, std::memory_order_release);
+            _dequeuePos = pos + 1;
+            return true;
+        }
+
+        static constexpr std::size_t capacity() { return Capacity; }
+
+    private:
+        static constexpr std::size_t kMask = Capacity - 1;
+
+        struct Cell
+        {
+            std::atomic<std::size_t> sequence{ 0 };
+            T value{};
+        };
+
+        std::array<Cell, Capacity> _cells{};
+        alignas(64) std::atomic<std::size_t> _enqueuePos{ 0 };
+        alignas(64) std::size_t _dequeuePos{ 0 };
+    };
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Knockback/Lod.h>
+#include <Knockback/Pool.h>
+#include <Knockback/World.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace Knockback
+{
+    enum class JobKind : std::uint8_t
+    {
+        kAttackDeferral,
+        kShove,
+        kEffectivenessCheck
+    };
+
+    // One pending knockback step. Plain data only: the scheduler stores these by value
+    // in its wheel slots, so waiting N frames costs nothing but the slot entry.
+    struct Job
+    {
+        ActorId aggressor{ 0 };
+        ActorId target{ 0 };
+        float weaponMult{ 0.0f };
+        float distance{ -1.0f };     // effectiveness: distBefore
+        std::int32_t tries{ 0 };
+        std::int32_t counter{ 0 };   // deferral: remaining wait frames, shove: attempt (1-based),
+                                     // effectiveness: reapplies so far
+        std::uint32_t generation{ 0 }; // owning chain in the per-target registry
+        JobKind kind{ JobKind::kShove };
+        std::uint8_t deferrals{ 0 };   // frames this step already waited for the frame budget
+        Lod::Tier lod{ Lod::Tier::kNear }; // distance tier picked when the hit was submitted
+    };
+
+    // Runs job delayFrames frames after the next scheduler tick (0 == next frame).
+    void ScheduleJob(const Job& job, std::int32_t delayFrames);
+
+    std::uint64_t GetSchedulerFrame();
+    std::size_t GetPendingJobCount();
+    // Job record storage: live records, peak, and how often it had to grow.
+    PoolStats GetJobPoolStats();
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+// Minimum-separation enforcement after a player shove. Active (aggressor, target) pairs
+// live in one dense array owned by the controller instead of re-queued jobs; each tick
+// updates every due pair in one pass, merges the pushes for a shared aggressor into a
+// single ApplyCurrent, and retires pairs that reached the distance, stalled or ran out
+// of tries. Game-free; main thread (scheduler tick) only.
+
+#include <Knockback/Settings.h>
+#include <Knockback/World.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace Knockback::Separation
+{
+    // Starts the pair, or restarts it (fresh tries, new snapshot) if it is already active.
+    // cfg is the snapshot of the chain whose shove just took.
+    void Engage(SettingsPtr cfg, ActorId aggressor, ActorId target, std::uint64_t frame);
+
+    // Runs the pairs due at frame.
+    void Update(IWorld& world, std::uint64_t frame);
+    // Drops every pair without another push; returns how many there were.
+    std::size_t Clear();
+
+    // The scheduler keeps ticking while this is non-zero.
+    std::size_t ActivePairCount();
+    std::size_t PairHighWater();
+}
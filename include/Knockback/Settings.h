@@ -0,0 +1,81 @@
+#pragma once
+
+// Game-independent tunables. Config (Config.h) adds the form tables on top; the
+// scheduling/shove core only ever sees this part, so it also builds headless (tools/).
+
+#include <cstdint>
+#include <memory>
+
+namespace Knockback
+{
+    struct Settings
+    {
+        // Bumped on every publish; snapshots are immutable once published.
+        std::uint64_t epoch{ 0 };
+
+        // Interpreted as "speed" for ApplyCurrent (units are game/Havok-y; tune by feel).
+        float shoveMagnitude{ 2.5f };
+        float shoveDuration{ 0.12f };
+
+        // acceptance helper (not a gameplay min)
+        float applyCurrentMinVelocity{ 4.0f };
+        float minDurationScale{ 0.15f };
+
+        // Attempts to apply shove
+        std::int32_t shoveRetries{ 3 };
+        std::int32_t shoveRetryDelayFrames{ 1 };
+
+        // Delay before first shove attempt (helps avoid same-tick controller clobber)
+        std::int32_t shoveInitialDelayFrames{ 1 };
+
+        // If after a shove the target hasn't separated by at least this many units, reapply shove.
+        float minShoveSeparationDelta{ 8.0f };
+
+        // Learn per race/aggressor whether retries and reapplies ever help, and stop spending
+        // them where they don't (Adaptive.h). shoveRetries and shoveInitialDelayFrames stay the
+        // ceiling and floor; these are the other ends of the range.
+        bool adaptiveRetries{ false };
+        std::int32_t adaptiveMinRetries{ 1 };
+        std::int32_t adaptiveMaxInitialDelayFrames{ 3 };
+
+        // Per-frame cap on shove/effectiveness jobs and on the tick's measured CPU time; 0 = no
+        // cap. Work over the cap waits a frame by priority (Budget.h); with frameBudgetDegrade,
+        // a cap that keeps being hit switches off effectiveness checks, then separation, then
+        // NPC-vs-NPC shoves until frames fit again.
+        std::int32_t frameBudgetJobs{ 0 };
+        std::int32_t frameBudgetMicros{ 0 };
+        bool frameBudgetDegrade{ true };
+
+        // Distance level of detail for NPC-vs-NPC hits, measured from the camera (Lod.h);
+        // 0 = tier off. Beyond mid: one attempt, no effectiveness checks. Beyond far: skipped,
+        // or with lodFarImpulse one ApplyCurrent at the hit, without a chain.
+        float lodMidDistance{ 0.0f };
+        float lodFarDistance{ 0.0f };
+        bool lodFarImpulse{ false };
+
+        // POV option: suppress when player aggressor in first-person
+        bool disableInFirstPerson{ true };
+
+        // Separation enforcement (player aggressor only)
+        bool enforceMinSeparation{ true };
+        float minSeparationDistance{ 110.0f };
+        float separationPushDuration{ 0.10f };
+        float separationMaxVelocity{ 10.0f };
+        std::int32_t separationRetries{ 6 };
+        std::int32_t separationInitialDelayFrames{ 1 };
+        std::int32_t separationRetryDelayFrames{ 1 };
+
+        // WeaponType magnitude multipliers (keyword table lives in Config)
+        float unarmedMultiplier{ 0.85f };
+        float powerAttackMultiplier{ 1.2f };
+
+        // Logging: route trace lines to the async binary log (decode with KnockbackLogDecode)
+        bool asyncBinaryTrace{ false };
+        // Seconds between pipeline stats summaries (KnockbackPlugin.stats); 0 = off
+        std::int32_t statsIntervalSeconds{ 0 };
+        // Record hits, world reads and outcomes to KnockbackPlugin.kbcap (read at startup only)
+        bool captureTrace{ false };
+    };
+
+    using SettingsPtr = std::shared_ptr<const Settings>;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+// Every INI-backed Settings field, declared once: section, key, type, clamp and whether the
+// MCM file carries it. The default is the Settings member initializer. Loading, clamping and
+// seeding the MCM file all walk this table. Game-free.
+
+#include <Knockback/Ini.h>
+#include <Knockback/Settings.h>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace Knockback::Schema
+{
+    enum class Type : std::uint8_t
+    {
+        kFloat,
+        kInt,
+        kBool
+    };
+
+    struct Field
+    {
+        std::string_view section;
+        std::string_view key;               // legacy INI key; the MCM key adds the type letter (fShoveMagnitude)
+        Type type{ Type::kFloat };
+        float Settings::*f{ nullptr };
+        std::int32_t Settings::*i{ nullptr };
+        bool Settings::*b{ nullptr };
+        double min{ -std::numeric_limits<double>::infinity() };
+        double max{ std::numeric_limits<double>::infinity() };
+        bool mcm{ false };                  // also read from, and seeded into, the MCM file
+    };
+
+    std::span<const Field> Fields();
+
+    enum class Layer : std::uint8_t
+    {
+        kLegacy,   // KnockbackPlugin.ini: every field, plain keys
+        kMcm       // MCM settings: the mcm fields, typed key first, plain key as fallback
+    };
+
+    // One pass over doc. The first entry naming a field decides it, as SimpleIni's GetValue
+    // did; a value that does not parse keeps the current one. Returns the fields named.
+    std::size_t Apply(const Ini::Document& doc, Layer layer, Settings& out);
+
+    // Per-field ranges, then the limits that depend on other fields.
+    void Clamp(Settings& s);
+
+    // The MCM file for s: typed keys of the mcm fields, values formatted like SimpleIni's.
+    std::string FormatMcm(const Settings& s);
+}
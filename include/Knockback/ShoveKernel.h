@@ -0,0 +1,49 @@
+#pragma once
+
+// Batched shove geometry for one scheduler tick, stored structure-of-arrays so the
+// kernel can process 4 (SSE) or 8 (AVX) actor pairs per instruction.
+
+#include <Knockback/Settings.h>
+#include <Knockback/World.h>
+#include <cstddef>
+#include <vector>
+
+namespace Knockback
+{
+    struct ShoveBatch
+    {
+        // Inputs
+        std::vector<float> aggressorX, aggressorY;
+        std::vector<float> targetX, targetY;
+        std::vector<float> baseMagnitude;      // shove lanes: shoveMagnitude * weaponMult
+        std::vector<float> baseDuration;       // shove: shoveDuration, separation: separationPushDuration
+        std::vector<float> minVelocity;        // ShapeForApplyCurrent knobs of the lane's snapshot
+        std::vector<float> minDurationScale;
+        std::vector<float> separation;         // 1: magnitude comes from the distance deficit
+        std::vector<float> separationMinDistance;
+        std::vector<float> separationMaxVelocity;
+
+        // Outputs. dir is the XY unit vector aggressor -> target, (0, 0) when degenerate.
+        std::vector<float> distance;
+        std::vector<float> dirX, dirY;
+        std::vector<float> magnitude;          // shaped
+        std::vector<float> duration;           // shaped
+
+        std::size_t size() const { return aggressorX.size(); }
+        void clear();
+
+        std::size_t AddShove(const Vec3& aggressor, const Vec3& target, const Settings& cfg, float weaponMult);
+        std::size_t AddSeparation(const Vec3& aggressor, const Vec3& target, const Settings& cfg);
+    };
+
+    // Fills the outputs for every lane: distance, unit direction, then the magnitude
+    // (separation lanes: deficit / duration, capped) shaped like ShapeForApplyCurrent.
+    void ComputeShoveGeometry(ShoveBatch& batch);
+
+    // Lane-at-a-time reference of the same math, built on HorizontalDistance and
+    // ShapeForApplyCurrent.
+    void ComputeShoveGeometryScalar(ShoveBatch& batch);
+
+    // Widest path compiled in: 8 (AVX), 4 (SSE) or 1 (scalar only).
+    std::size_t ShoveKernelLanes();
+}
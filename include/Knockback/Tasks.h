@@ -1,36 +1,43 @@
 #pragma once
 
-#include <RE/Skyrim.h>
+#include <Knockback/Scheduler.h>
+#include <Knockback/World.h>
 #include <cstdint>
+#include <vector>
 
 namespace Knockback
 {
-    void QueuePhysicsShove(
-        RE::ActorHandle aggressorH,
-        RE::ActorHandle targetH,
-        std::int32_t remainingTries,
-        std::int32_t delayFrames,
-        float weaponMult);
+    // A hit that already passed the game-side gates (projectile, magic, weapon lookup).
+    struct HitEvent
+    {
+        ActorId aggressor{ 0 };
+        ActorId target{ 0 };
+        float weaponMult{ 0.0f };   // weapon multiplier, power attack already folded in
+        std::uint64_t postedMicros{ 0 };   // Metrics::NowMicros() when the game fired the hit; 0 = unknown
+    };
 
-    static void QueueShoveEffectivenessCheck(
-        RE::ActorHandle aggressorH,
-        RE::ActorHandle targetH,
-        std::int32_t remainingTries,
-        float distBefore,
-        std::int32_t delayFrames,
-        float weaponMult);
-    
-    void QueueEnforceMinSeparation(RE::ActorHandle aggressorH,
-        RE::ActorHandle targetH,
-        std::int32_t remainingTries,
-        std::int32_t delayFrames,
-        float lastDist = -1.0f,
-        std::int32_t noProgressCount = 0);
+    // Game-independent part of the hit path: actor gates against the current settings,
+    // then starts (or merges into) the target's chain.
+    void SubmitHit(const HitEvent& hit);
 
+    // Same, for one frame's worth of hits against a single settings snapshot. Consecutive
+    // hits from one aggressor with the same multiplier are one attack: the aggressor is
+    // gated once for all of its victims.
+    void SubmitHits(const std::vector<HitEvent>& hits);
+    // With a snapshot the caller already pinned (the hit drain classified the batch under it).
+    void SubmitHits(const SettingsPtr& cfg, const std::vector<HitEvent>& hits);
+
+    // Starts (or merges into) the target's deferral -> shove -> effectiveness chain
+    // (and, once it shoves, the separation pair) without any gating.
     void QueuePhysicsShoveWithAttackDeferral(
-        RE::ActorHandle aggressorH,
-        RE::ActorHandle targetH,
+        ActorId aggressor,
+        ActorId target,
         std::int32_t tries,
         float weaponMult,
         std::int32_t remainingWaitFrames);
+
+    // Scheduler callback: executes one tick's due jobs on the main thread. Shove and
+    // effectiveness jobs share one batched geometry pass (ShoveKernel.h); the separation
+    // controller (Separation.h) then updates its pairs.
+    void RunJobs(const std::vector<Job>& due);
 }
@@ -0,0 +1,88 @@
+#pragma once
+
+// The seam between the decision/scheduling core and the game. GameWorld implements it
+// over CommonLib; tools/KnockbackSim implements it over a synthetic actor table.
+
+#include <Knockback/Settings.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Knockback
+{
+    // Actor reference as the core sees it: the game's native ref handle (0 == none).
+    using ActorId = std::uint32_t;
+
+    struct Vec3
+    {
+        float x{ 0.0f };
+        float y{ 0.0f };
+        float z{ 0.0f };
+    };
+
+    struct ActorState
+    {
+        Vec3 position;
+        bool dead{ false };
+        bool player{ false };
+        std::uint32_t race{ 0 };   // race FormID (0 == unknown); keys the adaptive retry table
+    };
+
+    enum class AttackEventKind : std::uint8_t
+    {
+        kStart,   // attack started, or a swing that keeps it going
+        kEnd      // attack finished or was interrupted
+    };
+
+    struct AttackEvent
+    {
+        ActorId actor{ 0 };
+        AttackEventKind kind{ AttackEventKind::kStart };
+    };
+
+    // Attack animation events for actors the core asked about (AttackTracker.h). The game
+    // feeds it from animation graph sinks on whatever thread fires them; the simulation from
+    // its own attack toggles. The core calls both methods from the main thread.
+    class IAttackEventSource
+    {
+    public:
+        virtual ~IAttackEventSource() = default;
+
+        // Start reporting id's attack events. False if it cannot (no animation graph).
+        virtual bool Watch(ActorId id) = 0;
+        // Appends the events received since the last call, in arrival order.
+        virtual void Drain(std::vector<AttackEvent>& out) = 0;
+    };
+
+    class IWorld
+    {
+    public:
+        virtual ~IWorld() = default;
+
+        // Current settings snapshot; chains pin the one they start with.
+        virtual SettingsPtr AcquireSettings() = 0;
+
+        // False if id no longer resolves to a live reference.
+        virtual bool GetActorState(ActorId id, ActorState& out) const = 0;
+        virtual bool IsAttacking(ActorId id) const = 0;
+        // Event feed that replaces IsAttacking polling where available; nullptr = poll only.
+        virtual IAttackEventSource* AttackEvents() = 0;
+
+        // Filters, evaluated against the snapshot the calling chain pinned.
+        virtual bool IsValidTarget(const Settings& settings, ActorId target) const = 0;
+        virtual bool SuppressedByFirstPerson(const Settings& settings, ActorId aggressor) const = 0;
+
+        // Where the camera is; ranks jobs when the frame budget is tight. False if unknown.
+        virtual bool GetCameraPosition(Vec3& out) const = 0;
+
+        // ApplyCurrent on the target's character controller. False if it has no 3D/controller.
+        virtual bool ApplyCurrent(ActorId target, const Vec3& velocity, float duration) = 0;
+
+        // Runs fn on the main thread at the next opportunity (SKSE task queue in game).
+        virtual bool AddTask(std::function<void()> fn) = 0;
+    };
+
+    // Set once at startup, before the first hit is submitted.
+    void SetWorld(IWorld& world);
+    IWorld& GetWorld();
+}
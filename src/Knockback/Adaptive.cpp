@@ -0,0 +1,281 @@
+#include <Knockback/Adaptive.h>
+
+#include <Knockback/Metrics.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Knockback::Adaptive
+{
+    // Attempts (and reapplies) tracked per key; Config clamps shoveRetries to this.
+    constexpr std::size_t kMaxSteps = 10;
+    // Samples a step needs before it may be trimmed.
+    constexpr std::uint32_t kMinSamples = 16;
+    // A step that takes less often than this is not worth its task and ApplyCurrent.
+    constexpr double kUselessRate = 0.10;
+    // First attempts between initial-delay evaluations.
+    constexpr std::uint32_t kEvaluateEvery = 32;
+    // A step's counts are halved past this many samples, so the table follows the game
+    // (other cells, other mods) instead of averaging over the whole session. A raised
+    // initial delay is also probed one frame lower after this many first attempts.
+    constexpr std::uint32_t kWindow = 512;
+    // One decision in this many per key ignores the table, so trimmed steps keep being sampled.
+    constexpr std::uint32_t kExploreEvery = 16;
+    constexpr std::int32_t kMaxExtraDelay = 8;
+
+    struct StepCounts
+    {
+        std::array<std::uint32_t, kMaxSteps> reached{};
+        std::array<std::uint32_t, kMaxSteps> ok{};
+
+        void Record(std::size_t step, bool took)
+        {
+            if (step >= kMaxSteps) {
+                return;
+            }
+            ++reached[step];
+            ok[step] += took ? 1 : 0;
+
+            // Per step: late attempts are rare and would never reach kMinSamples if they
+            // were halved along with the first.
+            if (reached[step] > kWindow) {
+                reached[step] /= 2;
+                ok[step] /= 2;
+            }
+        }
+
+        // Longest prefix of steps worth running: trailing steps that have enough samples and
+        // almost never take are dropped, down to floor.
+        std::int32_t Keep(std::int32_t ceiling, std::int32_t floor) const
+        {
+            std::int32_t keep = ceiling;
+            while (keep > floor) {
+                const auto i = static_cast<std::size_t>(keep - 1);
+                if (i >= kMaxSteps || reached[i] < kMinSamples || ok[i] >= kUselessRate * reached[i]) {
+                    break;
+                }
+                --keep;
+            }
+            return keep;
+        }
+
+        std::int32_t Deepest() const
+        {
+            std::int32_t deepest = 0;
+            for (std::size_t i = 0; i < kMaxSteps; ++i) {
+                if (reached[i] > 0) {
+                    deepest = static_cast<std::int32_t>(i + 1);
+                }
+            }
+            return deepest;
+        }
+    };
+
+    struct Entry
+    {
+        StepCounts shove;    // step n = ApplyCurrent attempt n + 1
+        StepCounts effect;   // step n = effectiveness check after n reapplies
+        std::int32_t extraDelay{ 0 };
+        std::uint32_t sinceEvaluate{ 0 };
+        std::uint32_t sinceDelayChange{ 0 };
+        std::uint32_t decisions{ 0 };
+    };
+
+    // Written on the main thread; the stats writer thread reads it through FormatTable.
+    static std::unordered_map<std::uint64_t, Entry> g_table{};
+    static std::mutex g_tableMutex{};
+
+    static Entry& Lookup(const Key& key)
+    {
+        const auto packed = (static_cast<std::uint64_t>(key.race) << 1) | (key.player ? 1u : 0u);
+        return g_table[packed];
+    }
+
+    static bool Explore(Entry& e)
+    {
+        return ++e.decisions % kExploreEvery == 0;
+    }
+
+    // First attempts that fail but are rescued by a retry suggest the first one comes too
+    // early (the controller is still busy with the hit); wait one more frame. A raised delay
+    // is probed back down once per window, and climbs again if the failures come back.
+    static void EvaluateInitialDelay(Entry& e)
+    {
+        ++e.sinceDelayChange;
+        if (++e.sinceEvaluate < kEvaluateEvery) {
+            return;
+        }
+        e.sinceEvaluate = 0;
+
+        const auto& s = e.shove;
+        const std::uint32_t first = s.reached[0];
+        if (first < kMinSamples) {
+            return;
+        }
+        const std::uint32_t failed = first - s.ok[0];
+        std::uint32_t rescued = 0;
+        for (std::size_t i = 1; i < kMaxSteps; ++i) {
+            rescued += s.ok[i];
+        }
+
+        std::int32_t next = e.extraDelay;
+        if (failed * 4 > first && rescued * 2 >= failed) {
+            next = std::min(e.extraDelay + 1, kMaxExtraDelay);
+        }
+        else if (e.extraDelay > 0 && e.sinceDelayChange >= kWindow) {
+            next = e.extraDelay - 1;
+        }
+
+        if (next != e.extraDelay) {
+            // Attempt counts were measured at the old delay.
+            e.extraDelay = next;
+            e.shove = {};
+            e.sinceDelayChange = 0;
+        }
+    }
+
+    std::int32_t ShoveTries(const Settings& cfg, const Key& key)
+    {
+        if (!cfg.adaptiveRetries) {
+            return cfg.shoveRetries;
+        }
+
+        std::scoped_lock lock(g_tableMutex);
+        auto& e = Lookup(key);
+        const auto floor = std::min(cfg.adaptiveMinRetries, cfg.shoveRetries);
+        const auto keep = e.shove.Keep(cfg.shoveRetries, floor);
+        if (keep == cfg.shoveRetries) {
+            return keep;
+        }
+        if (Explore(e)) {
+            Metrics::Add(Metrics::Counter::kAdaptiveExplore);
+            return cfg.shoveRetries;
+        }
+        Metrics::Add(Metrics::Counter::kAdaptiveTriesCut);
+        return keep;
+    }
+
+    std::int32_t InitialDelayFrames(const Settings& cfg, const Key& key)
+    {
+        if (!cfg.adaptiveRetries) {
+            return cfg.shoveInitialDelayFrames;
+        }
+
+        std::scoped_lock lock(g_tableMutex);
+        const auto& e = Lookup(key);
+        if (e.extraDelay == 0) {
+            return cfg.shoveInitialDelayFrames;
+        }
+        const auto delay = std::min(cfg.shoveInitialDelayFrames + e.extraDelay,
+            std::max(cfg.adaptiveMaxInitialDelayFrames, cfg.shoveInitialDelayFrames));
+        if (delay > cfg.shoveInitialDelayFrames) {
+            Metrics::Add(Metrics::Counter::kAdaptiveDelayRaised);
+        }
+        return delay;
+    }
+
+    std::int32_t EffectTries(const Settings& cfg, const Key& key, std::int32_t remaining, std::int32_t attempt)
+    {
+        if (!cfg.adaptiveRetries) {
+            return remaining;
+        }
+
+        // Reapplies are learned on their own; a trimmed shove budget must not starve them.
+        remaining = std::max(remaining, cfg.shoveRetries - attempt + 1);
+        if (remaining <= 1) {
+            return remaining;
+        }
+
+        std::scoped_lock lock(g_tableMutex);
+        auto& e = Lookup(key);
+        const auto keep = e.effect.Keep(remaining, 1);
+        if (keep == remaining) {
+            return remaining;
+        }
+        if (Explore(e)) {
+            Metrics::Add(Metrics::Counter::kAdaptiveExplore);
+            return remaining;
+        }
+        if (keep > 1) {
+            return keep;
+        }
+        // A check that may not reapply only observes; skip it.
+        Metrics::Add(Metrics::Counter::kAdaptiveEffectSkipped);
+        return 0;
+    }
+
+    void RecordShove(const Key& key, std::int32_t attempt, bool ok)
+    {
+        if (attempt < 1) {
+            return;
+        }
+
+        std::scoped_lock lock(g_tableMutex);
+        auto& e = Lookup(key);
+        e.shove.Record(static_cast<std::size_t>(attempt - 1), ok);
+        if (attempt == 1) {
+            EvaluateInitialDelay(e);
+        }
+    }
+
+    void RecordEffect(const Key& key, std::int32_t reapplies, bool ok)
+    {
+        if (reapplies < 0) {
+            return;
+        }
+
+        std::scoped_lock lock(g_tableMutex);
+        Lookup(key).effect.Record(static_cast<std::size_t>(reapplies), ok);
+    }
+
+    std::size_t KeyCount()
+    {
+        std::scoped_lock lock(g_tableMutex);
+        return g_table.size();
+    }
+
+    static void AppendSteps(std::string& out, const char* label, const StepCounts& s)
+    {
+        char buf[48];
+        out += label;
+        const auto deepest = s.Deepest();
+        for (std::int32_t i = 0; i < deepest; ++i) {
+            std::snprintf(buf, sizeof(buf), " %u/%u", s.ok[static_cast<std::size_t>(i)], s.reached[static_cast<std::size_t>(i)]);
+            out += buf;
+        }
+        if (deepest == 0) {
+            out += " -";
+        }
+    }
+
+    std::string FormatTable()
+    {
+        std::vector<std::pair<std::uint64_t, Entry>> rows;
+        {
+            std::scoped_lock lock(g_tableMutex);
+            rows.assign(g_table.begin(), g_table.end());
+        }
+        std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        // Per step: took/reached. keep = steps still worth running before the configured bounds.
+        std::string out = "adaptive (race aggressor: keep, +delay | shove attempt took/reached | effect check took/reached)\n";
+        char buf[96];
+        for (const auto& [packed, e] : rows) {
+            const auto race = static_cast<std::uint32_t>(packed >> 1);
+            const bool player = (packed & 1) != 0;
+            const auto deepest = std::max(1, e.shove.Deepest());
+            std::snprintf(buf, sizeof(buf), "%08X %-6s: keep %d/%d, +%d |", race, player ? "player" : "npc",
+                e.shove.Keep(deepest, 1), deepest, e.extraDelay);
+            out += buf;
+            AppendSteps(out, "", e.shove);
+            AppendSteps(out, " |", e.effect);
+            out += '\n';
+        }
+        return out;
+    }
+}
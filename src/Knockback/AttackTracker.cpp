@@ -0,0 +1,130 @@
+#include <Knockback/AttackTracker.h>
+
+#include <Knockback/BinLog.h>
+#include <Knockback/Metrics.h>
+
+#include <memory_resource>
+#include <unordered_map>
+
+namespace Knockback::Attacks
+{
+    // A watched actor that has been quiet this long is watched and read again on its next
+    // query: its animation graph may have been rebuilt (unloaded and reloaded) without our
+    // sink. Actors the source refused are retried after the same time.
+    constexpr std::uint64_t kRewatchFrames = 300;
+    // Entries untouched this long are forgotten; checked every kPruneFrames.
+    constexpr std::uint64_t kForgetFrames = 3600;
+    constexpr std::uint64_t kPruneFrames = 1024;
+
+    struct Entry
+    {
+        bool watched{ false };
+        bool attacking{ false };
+        std::uint64_t touched{ 0 };   // frame of the last watch or event
+    };
+
+    struct Parked
+    {
+        Job job;
+        std::uint64_t deadline{ 0 };
+    };
+
+    // Main-thread only. Entries recycle their nodes like the chain registry does.
+    static std::pmr::unsynchronized_pool_resource g_entryNodes{};
+    static std::pmr::unordered_map<ActorId, Entry> g_entries{ &g_entryNodes };
+    static std::vector<Parked> g_parked{};
+    static std::vector<AttackEvent> g_events{};   // per tick; capacity is reused
+    static std::uint64_t g_lastPrune{ 0 };
+
+    State Query(IWorld& world, ActorId id, std::uint64_t frame)
+    {
+        auto* source = world.AttackEvents();
+        if (!source) {
+            return State::kUnwatched;
+        }
+
+        auto [it, inserted] = g_entries.try_emplace(id);
+        auto& entry = it->second;
+        if (inserted || frame - entry.touched >= kRewatchFrames) {
+            entry.watched = source->Watch(id);
+            // Events only say what changes from here on; the current state is read once.
+            entry.attacking = entry.watched && world.IsAttacking(id);
+            entry.touched = frame;
+            KB_TRACE("Attacks: watch {:08X} ok={} attacking={}", id, entry.watched, entry.attacking);
+        }
+
+        if (!entry.watched) {
+            return State::kUnwatched;
+        }
+        return entry.attacking ? State::kAttacking : State::kIdle;
+    }
+
+    void Park(const Job& job, std::uint64_t deadline)
+    {
+        g_parked.push_back(Parked{ job, deadline });
+        Metrics::Add(Metrics::Counter::kDeferralParked);
+    }
+
+    static void ApplyEvents(IAttackEventSource& source, std::uint64_t frame)
+    {
+        g_events.clear();
+        source.Drain(g_events);
+
+        for (const auto& event : g_events) {
+            const auto it = g_entries.find(event.actor);
+            if (it == g_entries.end() || !it->second.watched) {
+                continue;
+            }
+            it->second.attacking = event.kind == AttackEventKind::kStart;
+            it->second.touched = frame;
+        }
+        Metrics::Add(Metrics::Counter::kAttackEvents, g_events.size());
+    }
+
+    static void Prune(std::uint64_t frame)
+    {
+        if (frame - g_lastPrune < kPruneFrames) {
+            return;
+        }
+        g_lastPrune = frame;
+
+        // Parked targets were touched within the deferral cap, far inside kForgetFrames.
+        for (auto it = g_entries.begin(); it != g_entries.end();) {
+            it = frame - it->second.touched >= kForgetFrames ? g_entries.erase(it) : std::next(it);
+        }
+    }
+
+    void BeginTick(IWorld& world, std::uint64_t frame, std::vector<Job>& woken)
+    {
+        if (auto* source = world.AttackEvents()) {
+            ApplyEvents(*source, frame);
+        }
+
+        // Hand back in parking order; the rest keep theirs.
+        std::size_t kept = 0;
+        for (auto& parked : g_parked) {
+            const auto it = g_entries.find(parked.job.target);
+            const bool ended = it == g_entries.end() || !it->second.attacking;
+            if (!ended && parked.deadline > frame) {
+                g_parked[kept++] = parked;
+                continue;
+            }
+
+            Metrics::Add(ended ? Metrics::Counter::kDeferralWoken : Metrics::Counter::kDeferralTimedOut);
+            woken.push_back(parked.job);
+        }
+        g_parked.resize(kept);
+
+        Prune(frame);
+    }
+
+    std::size_t ParkedCount()
+    {
+        return g_parked.size();
+    }
+
+    std::size_t WatchedCount()
+    {
+        return g_entries.size();
+    }
+}
@@ -0,0 +1,200 @@
+#include <Knockback/BinLog.h>
+
+#include <Knockback/Ring.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if !defined(KNOCKBACK_HEADLESS)
+namespace logger = SKSE::log;
+#endif
+
+namespace Knockback::BinLog
+{
+    std::atomic_bool g_enabled{ false };
+
+    namespace
+    {
+        constexpr std::size_t kRingCapacity = 8192;
+        constexpr std::size_t kBatchSize = 512;
+        constexpr auto kIdleSleep = std::chrono::milliseconds(5);
+
+        using RecordRing = MpscRing<Record, kRingCapacity>;
+
+        // One ring for the life of the process: producers that see g_enabled never find it
+        // missing or replaced, whichever thread Start/Stop run on.
+        RecordRing g_ring{};
+        std::atomic<std::uint64_t> g_dropped{ 0 };
+        std::atomic<std::uint32_t> g_nextThreadIndex{ 0 };
+
+        std::mutex g_formatsMutex{};
+        std::vector<std::string> g_formats{};
+        std::unordered_map<std::string_view, std::uint16_t> g_formatIds{};
+        std::size_t g_formatsWritten{ 0 };
+
+        std::FILE* g_file{ nullptr };
+        std::jthread g_writer{};
+
+        void ReportStatus(bool error, const std::string& msg)
+        {
+#if defined(KNOCKBACK_HEADLESS)
+            (void)error;
+            std::fprintf(stderr, "%s\n", msg.c_str());
+#else
+            if (error) {
+                logger::error("{}", msg);
+            }
+            else {
+                logger::info("{}", msg);
+            }
+#endif
+        }
+
+        void WriteChunkTag(ChunkTag tag)
+        {
+            const auto b = static_cast<std::uint8_t>(tag);
+            std::fwrite(&b, 1, 1, g_file);
+        }
+
+        // Definitions go out before any record that references them.
+        void WritePendingFormats()
+        {
+            std::scoped_lock lock(g_formatsMutex);
+
+            for (; g_formatsWritten < g_formats.size(); ++g_formatsWritten) {
+                const auto& fmt = g_formats[g_formatsWritten];
+                const auto id = static_cast<std::uint16_t>(g_formatsWritten);
+                const auto len = static_cast<std::uint16_t>(std::min<std::size_t>(fmt.size(), 0xFFFF));
+
+                WriteChunkTag(ChunkTag::kFormat);
+                std::fwrite(&id, sizeof(id), 1, g_file);
+                std::fwrite(&len, sizeof(len), 1, g_file);
+                std::fwrite(fmt.data(), 1, len, g_file);
+            }
+        }
+
+        // Pops up to one batch and writes it. Returns how many records were written.
+        std::size_t DrainBatch(std::vector<Record>& batch)
+        {
+            batch.clear();
+
+            Record r{};
+            while (batch.size() < kBatchSize && g_ring.TryPop(r)) {
+                batch.push_back(r);
+            }
+
+            if (const auto dropped = g_dropped.exchange(0, std::memory_order_relaxed); dropped > 0) {
+                WriteChunkTag(ChunkTag::kDropped);
+                std::fwrite(&dropped, sizeof(dropped), 1, g_file);
+            }
+
+            if (batch.empty()) {
+                return 0;
+            }
+
+            WritePendingFormats();
+            for (const auto& rec : batch) {
+                WriteChunkTag(ChunkTag::kRecord);
+                std::fwrite(&rec, sizeof(rec), 1, g_file);
+            }
+            std::fflush(g_file);
+            return batch.size();
+        }
+
+        void WriterLoop(std::stop_token stop)
+        {
+            std::vector<Record> batch;
+            batch.reserve(kBatchSize);
+
+            while (!stop.stop_requested()) {
+                if (DrainBatch(batch) == 0) {
+                    std::this_thread::sleep_for(kIdleSleep);
+                }
+            }
+
+            while (DrainBatch(batch) > 0) {
+            }
+        }
+    }
+
+    bool Start(const std::filesystem::path& path)
+    {
+        if (g_writer.joinable()) {
+            return true;
+        }
+
+        g_file = std::fopen(path.string().c_str(), "wb");
+        if (!g_file) {
+            ReportStatus(true, "BinLog: could not open " + path.string());
+            return false;
+        }
+
+        const FileHeader header{ kFileMagic, kFileVersion, static_cast<std::uint16_t>(sizeof(Record)) };
+        std::fwrite(&header, sizeof(header), 1, g_file);
+
+        {
+            // Ids stay valid across restarts, so re-emit every known format into the new file.
+            std::scoped_lock lock(g_formatsMutex);
+            g_formatsWritten = 0;
+        }
+
+        g_writer = std::jthread(WriterLoop);
+        g_enabled.store(true, std::memory_order_release);
+
+        ReportStatus(false, "BinLog: binary trace enabled -> " + path.string());
+        return true;
+    }
+
+    void Stop()
+    {
+        if (!g_writer.joinable()) {
+            return;
+        }
+
+        g_enabled.store(false, std::memory_order_release);
+        g_writer.request_stop();
+        g_writer.join();
+
+        std::fclose(g_file);
+        g_file = nullptr;
+
+        ReportStatus(false, "BinLog: binary trace disabled");
+    }
+
+    std::uint16_t InternFormat(std::string_view fmt)
+    {
+        std::scoped_lock lock(g_formatsMutex);
+
+        if (const auto it = g_formatIds.find(fmt); it != g_formatIds.end()) {
+            return it->second;
+        }
+
+        const auto id = static_cast<std::uint16_t>(g_formats.size());
+        g_formats.emplace_back(fmt);
+        // Key on the caller's literal; it outlives the table.
+        g_formatIds.emplace(fmt, id);
+        return id;
+    }
+
+    void Push(Record record)
+    {
+        static thread_local const std::uint32_t threadIndex = g_nextThreadIndex.fetch_add(1, std::memory_order_relaxed);
+
+        record.timestampNs = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch())
+                .count());
+        record.threadIndex = threadIndex;
+
+        // Producers can race with Stop(); records pushed after it wait for the next Start.
+        if (!g_ring.TryPush(record)) {
+            g_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
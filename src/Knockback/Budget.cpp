@@ -0,0 +1,70 @@
+#include <Knockback/Budget.h>
+
+#include <Knockback/BinLog.h>
+#include <Knockback/Metrics.h>
+
+#include <algorithm>
+
+namespace Knockback::Budget
+{
+    // Overrunning ticks (net of good ones) that step the level up. About half a second of
+    // continuous overrun at 60 fps; an isolated spike leaks away before it gets there.
+    constexpr std::uint32_t kStepUpPressure = 30;
+    // Consecutive good ticks before a level is given back.
+    constexpr std::uint32_t kStepDownTicks = 300;
+
+    static Level g_level{ Level::kFull };
+    static std::uint32_t g_pressure{ 0 };
+    static std::uint32_t g_goodTicks{ 0 };
+
+    bool Enabled(const Settings& cfg)
+    {
+        return cfg.frameBudgetJobs > 0 || cfg.frameBudgetMicros > 0;
+    }
+
+    Level CurrentLevel()
+    {
+        return g_level;
+    }
+
+    static void SetLevel(Level level)
+    {
+        Metrics::Add(level > g_level ? Metrics::Counter::kDegradeStepUp : Metrics::Counter::kDegradeStepDown);
+        KB_TRACE("Budget: degradation level {} -> {}", static_cast<int>(g_level), static_cast<int>(level));
+        g_level = level;
+        g_pressure = 0;
+        g_goodTicks = 0;
+    }
+
+    void EndTick(const Settings& cfg, std::uint64_t micros, std::size_t overBudget)
+    {
+        if (!Enabled(cfg) || !cfg.frameBudgetDegrade) {
+            if (g_level != Level::kFull) {
+                SetLevel(Level::kFull);
+            }
+            Metrics::Set(Metrics::Gauge::kDegradeLevel, 0);
+            return;
+        }
+
+        const auto budgetMicros = static_cast<std::uint64_t>(std::max(0, cfg.frameBudgetMicros));
+        const bool overrun = overBudget > 0 || (budgetMicros > 0 && micros > budgetMicros);
+        // Hysteresis: a tick only counts as good with a quarter of the time budget to spare.
+        const bool good = overBudget == 0 && (budgetMicros == 0 || micros * 4 <= budgetMicros * 3);
+
+        if (overrun) {
+            g_goodTicks = 0;
+            if (++g_pressure >= kStepUpPressure && g_level < Level::kPlayerOnly) {
+                SetLevel(static_cast<Level>(static_cast<std::uint8_t>(g_level) + 1));
+            }
+        }
+        else {
+            g_pressure = g_pressure > 0 ? g_pressure - 1 : 0;
+            g_goodTicks = good ? g_goodTicks + 1 : 0;
+            if (g_goodTicks >= kStepDownTicks && g_level > Level::kFull) {
+                SetLevel(static_cast<Level>(static_cast<std::uint8_t>(g_level) - 1));
+            }
+        }
+
+        Metrics::Set(Metrics::Gauge::kDegradeLevel, static_cast<std::uint64_t>(g_level));
+    }
+}
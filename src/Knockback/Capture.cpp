@@ -0,0 +1,643 @@
+#include <Knockback/Capture.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+#if !defined(KNOCKBACK_HEADLESS)
+#include "SKSE/SKSE.h"
+namespace logger = SKSE::log;
+#endif
+
+namespace Knockback::Capture
+{
+    static_assert(std::is_trivially_copyable_v<Settings>, "Settings is captured byte for byte");
+
+    namespace
+    {
+        constexpr std::size_t kFlushBytes = 64 * 1024;
+        constexpr auto kFlushInterval = std::chrono::seconds(1);
+
+        void ReportStatus(bool error, const std::string& msg)
+        {
+#if defined(KNOCKBACK_HEADLESS)
+            (void)error;
+            std::fprintf(stderr, "%s\n", msg.c_str());
+#else
+            if (error) {
+                logger::error("{}", msg);
+            }
+            else {
+                logger::info("{}", msg);
+            }
+#endif
+        }
+
+        // Buffered append-only record stream. Callers hold Writer::mutex.
+        class Writer
+        {
+        public:
+            bool Open(const std::filesystem::path& path)
+            {
+                _file = std::fopen(path.string().c_str(), "wb");
+                if (!_file) {
+                    return false;
+                }
+
+                FileHeader header{};
+                header.settingsSize = static_cast<std::uint16_t>(sizeof(Settings));
+                Put(header);
+                Flush();
+                return true;
+            }
+
+            void Close()
+            {
+                if (_file) {
+                    Flush();
+                    std::fclose(_file);
+                    _file = nullptr;
+                }
+            }
+
+            template <class T>
+            void Put(const T& v)
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+                const auto* p = reinterpret_cast<const std::uint8_t*>(&v);
+                _buffer.insert(_buffer.end(), p, p + sizeof(T));
+            }
+
+            void PutTag(Tag tag) { Put(static_cast<std::uint8_t>(tag)); }
+            void PutBool(bool v) { Put(static_cast<std::uint8_t>(v ? 1 : 0)); }
+
+            // Called at driver events, so a crash loses at most about a second of capture.
+            void MaybeFlush()
+            {
+                const auto now = std::chrono::steady_clock::now();
+                if (_buffer.size() >= kFlushBytes || now - _lastFlush >= kFlushInterval) {
+                    Flush();
+                    _lastFlush = now;
+                }
+            }
+
+            void Flush()
+            {
+                if (_file && !_buffer.empty()) {
+                    std::fwrite(_buffer.data(), 1, _buffer.size(), _file);
+                    std::fflush(_file);
+                }
+                _buffer.clear();
+            }
+
+            std::mutex mutex;
+
+        private:
+            std::FILE* _file{ nullptr };
+            std::vector<std::uint8_t> _buffer;
+            std::chrono::steady_clock::time_point _lastFlush{};
+        };
+
+        // Forwards to the real world and logs what it answered. Always offers an attack
+        // event source, so the core makes the same calls on replay whether or not the real
+        // world had one; without one, nothing can be watched and nothing arrives.
+        class RecordingWorld final : public IWorld, public IAttackEventSource
+        {
+        public:
+            RecordingWorld(IWorld& inner, Writer& writer) :
+                _inner(inner), _writer(writer)
+            {}
+
+            IWorld& Inner() const { return _inner; }
+
+            SettingsPtr AcquireSettings() override
+            {
+                auto settings = _inner.AcquireSettings();
+
+                std::scoped_lock lock(_writer.mutex);
+                PutSettings(*settings);
+                return settings;
+            }
+
+            // A snapshot read from the world, or one the caller pinned earlier and hands to the
+            // core instead (RecordHits): replay serves both as an AcquireSettings answer.
+            // Caller holds _writer.mutex.
+            void PutSettings(const Settings& settings)
+            {
+                if (&settings == _lastSettings && settings.epoch == _lastEpoch) {
+                    _writer.PutTag(Tag::kSettingsSame);
+                }
+                else {
+                    _writer.PutTag(Tag::kSettings);
+                    _writer.Put(settings);
+                    _lastSettings = &settings;
+                    _lastEpoch = settings.epoch;
+                }
+            }
+
+            bool GetActorState(ActorId id, ActorState& out) const override
+            {
+                const bool ok = _inner.GetActorState(id, out);
+
+                std::scoped_lock lock(_writer.mutex);
+                _writer.PutTag(Tag::kActorState);
+                _writer.Put(id);
+                _writer.PutBool(ok);
+                _writer.Put(ok ? out.position.x : 0.0f);
+                _writer.Put(ok ? out.position.y : 0.0f);
+                _writer.Put(ok ? out.position.z : 0.0f);
+                _writer.PutBool(ok && out.dead);
+                _writer.PutBool(ok && out.player);
+                _writer.Put(ok ? out.race : std::uint32_t{ 0 });
+                return ok;
+            }
+
+            bool IsAttacking(ActorId id) const override
+            {
+                return Log(Tag::kAttacking, id, _inner.IsAttacking(id));
+            }
+
+            bool IsValidTarget(const Settings& settings, ActorId target) const override
+            {
+                return Log(Tag::kValidTarget, target, _inner.IsValidTarget(settings, target));
+            }
+
+            bool SuppressedByFirstPerson(const Settings& settings, ActorId aggressor) const override
+            {
+                return Log(Tag::kFirstPerson, aggressor, _inner.SuppressedByFirstPerson(settings, aggressor));
+            }
+
+            bool GetCameraPosition(Vec3& out) const override
+            {
+                const bool ok = _inner.GetCameraPosition(out);
+
+                std::scoped_lock lock(_writer.mutex);
+                _writer.PutTag(Tag::kCamera);
+                _writer.PutBool(ok);
+                _writer.Put(ok ? out.x : 0.0f);
+                _writer.Put(ok ? out.y : 0.0f);
+                _writer.Put(ok ? out.z : 0.0f);
+                return ok;
+            }
+
+            IAttackEventSource* AttackEvents() override { return this; }
+
+            bool Watch(ActorId id) override
+            {
+                auto* source = _inner.AttackEvents();
+                return Log(Tag::kWatch, id, source && source->Watch(id));
+            }
+
+            void Drain(std::vector<AttackEvent>& out) override
+            {
+                const auto first = out.size();
+                if (auto* source = _inner.AttackEvents()) {
+                    source->Drain(out);
+                }
+
+                std::scoped_lock lock(_writer.mutex);
+                _writer.PutTag(Tag::kAttackEvents);
+                _writer.Put(static_cast<std::uint32_t>(out.size() - first));
+                for (auto i = first; i < out.size(); ++i) {
+                    _writer.Put(out[i].actor);
+                    _writer.Put(static_cast<std::uint8_t>(out[i].kind));
+                }
+            }
+
+            bool ApplyCurrent(ActorId target, const Vec3& velocity, float duration) override
+            {
+                const bool ok = _inner.ApplyCurrent(target, velocity, duration);
+
+                std::scoped_lock lock(_writer.mutex);
+                _writer.PutTag(Tag::kApplyCurrent);
+                _writer.Put(target);
+                _writer.Put(velocity.x);
+                _writer.Put(velocity.y);
+                _writer.Put(velocity.z);
+                _writer.Put(duration);
+                _writer.PutBool(ok);
+                return ok;
+            }
+
+            bool AddTask(std::function<void()> fn) override
+            {
+                const bool ok = _inner.AddTask([this, fn = std::move(fn)]() {
+                    {
+                        std::scoped_lock lock(_writer.mutex);
+                        _writer.PutTag(Tag::kTask);
+                        _writer.MaybeFlush();
+                    }
+                    fn();
+                });
+
+                std::scoped_lock lock(_writer.mutex);
+                _writer.PutTag(Tag::kAddTask);
+                _writer.PutBool(ok);
+                return ok;
+            }
+
+        private:
+            bool Log(Tag tag, ActorId id, bool result) const
+            {
+                std::scoped_lock lock(_writer.mutex);
+                _writer.PutTag(tag);
+                _writer.Put(id);
+                _writer.PutBool(result);
+                return result;
+            }
+
+            IWorld& _inner;
+            Writer& _writer;
+            const Settings* _lastSettings{ nullptr };
+            std::uint64_t _lastEpoch{ 0 };
+        };
+
+        Writer g_writer{};
+        std::unique_ptr<RecordingWorld> g_recording{};
+    }
+
+    bool Start(const std::filesystem::path& path, IWorld& inner)
+    {
+        if (g_recording) {
+            return true;
+        }
+
+        if (!g_writer.Open(path)) {
+            ReportStatus(true, "Capture: could not open " + path.string());
+            return false;
+        }
+
+        g_recording = std::make_unique<RecordingWorld>(inner, g_writer);
+        SetWorld(*g_recording);
+
+        ReportStatus(false, "Capture: recording -> " + path.string());
+        return true;
+    }
+
+    void Stop()
+    {
+        if (!g_recording) {
+            return;
+        }
+
+        // Tasks already queued keep a pointer to the decorator, so it is never freed.
+        SetWorld(g_recording->Inner());
+        {
+            std::scoped_lock lock(g_writer.mutex);
+            g_writer.Close();
+        }
+        (void)g_recording.release();
+
+        ReportStatus(false, "Capture: stopped");
+    }
+
+    bool IsActive()
+    {
+        return g_recording != nullptr;
+    }
+
+    void RecordRawHit(std::uint32_t target, std::uint32_t aggressor, std::uint32_t source, std::uint32_t projectile,
+        std::uint8_t flags, std::uint64_t frame)
+    {
+        if (!g_recording) {
+            return;
+        }
+
+        std::scoped_lock lock(g_writer.mutex);
+        g_writer.PutTag(Tag::kRawHit);
+        g_writer.Put(target);
+        g_writer.Put(aggressor);
+        g_writer.Put(source);
+        g_writer.Put(projectile);
+        g_writer.Put(flags);
+        g_writer.Put(frame);
+    }
+
+    static void PutHits(const std::vector<HitEvent>& hits)
+    {
+        g_writer.PutTag(Tag::kHits);
+        g_writer.Put(static_cast<std::uint32_t>(hits.size()));
+        for (const auto& hit : hits) {
+            g_writer.Put(hit.aggressor);
+            g_writer.Put(hit.target);
+            g_writer.Put(hit.weaponMult);
+            g_writer.Put(hit.postedMicros);
+        }
+    }
+
+    void RecordHits(const std::vector<HitEvent>& hits)
+    {
+        if (!g_recording || hits.empty()) {
+            return;
+        }
+
+        std::scoped_lock lock(g_writer.mutex);
+        PutHits(hits);
+        g_writer.MaybeFlush();
+    }
+
+    void RecordHits(const std::vector<HitEvent>& hits, const Settings& cfg)
+    {
+        if (!g_recording || hits.empty()) {
+            return;
+        }
+
+        // Same bytes as RecordHits + SubmitHits(hits) reading the snapshot from the world.
+        std::scoped_lock lock(g_writer.mutex);
+        PutHits(hits);
+        g_recording->PutSettings(cfg);
+        g_writer.MaybeFlush();
+    }
+
+    // ---- Replay ----
+
+    bool ReplayWorld::Open(const std::filesystem::path& path)
+    {
+        std::FILE* file = std::fopen(path.string().c_str(), "rb");
+        if (!file) {
+            _error = "cannot open " + path.string();
+            return false;
+        }
+
+        std::uint8_t chunk[64 * 1024];
+        std::size_t n = 0;
+        while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+            _data.insert(_data.end(), chunk, chunk + n);
+        }
+        std::fclose(file);
+
+        FileHeader header{};
+        if (!Read(header) || header.magic != kFileMagic) {
+            _error = "not a capture file";
+            return false;
+        }
+        if (header.version != kFileVersion || header.settingsSize != sizeof(Settings)) {
+            _error = "capture was written by a different plugin version";
+            return false;
+        }
+
+        return true;
+    }
+
+    template <class T>
+    bool ReplayWorld::Read(T& out) const
+    {
+        if (_data.size() - _pos < sizeof(T)) {
+            // A capture still being written (or cut short by a crash) ends mid-record.
+            _ended = true;
+            return false;
+        }
+        std::memcpy(&out, _data.data() + _pos, sizeof(T));
+        _pos += sizeof(T);
+        return true;
+    }
+
+    void ReplayWorld::Fail(std::string msg) const
+    {
+        if (!_diverged) {
+            _diverged = true;
+            _error = std::move(msg) + " at byte " + std::to_string(_pos);
+        }
+    }
+
+    bool ReplayWorld::Expect(Tag tag, const char* what) const
+    {
+        std::uint8_t got = 0;
+        if (_diverged || _ended || !Read(got)) {
+            return false;
+        }
+        if (got != static_cast<std::uint8_t>(tag)) {
+            Fail(std::string("core asked for ") + what + ", capture has record '" + static_cast<char>(got) + "'");
+            return false;
+        }
+        return true;
+    }
+
+    bool ReplayWorld::ExpectIdBool(Tag tag, ActorId id, const char* what) const
+    {
+        if (!Expect(tag, what)) {
+            return false;
+        }
+
+        ActorId recorded = 0;
+        std::uint8_t result = 0;
+        if (!Read(recorded) || !Read(result)) {
+            return false;
+        }
+        if (recorded != id) {
+            Fail(std::string(what) + " for a different actor");
+            return false;
+        }
+        return result != 0;
+    }
+
+    ReplayWorld::Step ReplayWorld::Next()
+    {
+        if (_diverged) {
+            return Step::kDiverged;
+        }
+
+        std::uint8_t tag = 0;
+        if (_ended || _pos == _data.size() || !Read(tag)) {
+            return Step::kEnd;
+        }
+
+        switch (static_cast<Tag>(tag)) {
+        case Tag::kHits:
+            {
+                std::uint32_t count = 0;
+                if (!Read(count)) {
+                    return Step::kEnd;
+                }
+                _hits.resize(count);
+                for (auto& hit : _hits) {
+                    if (!Read(hit.aggressor) || !Read(hit.target) || !Read(hit.weaponMult) || !Read(hit.postedMicros)) {
+                        return Step::kEnd;
+                    }
+                }
+                return Step::kHits;
+            }
+        case Tag::kTask:
+            return Step::kTask;
+        case Tag::kRawHit:
+            {
+                std::uint32_t ids[4]{};
+                std::uint8_t flags = 0;
+                std::uint64_t frame = 0;
+                if (!Read(ids) || !Read(flags) || !Read(frame)) {
+                    return Step::kEnd;
+                }
+                ++_rawHits;
+                return Step::kRawHit;
+            }
+        default:
+            --_pos;
+            Fail(std::string("capture has record '") + static_cast<char>(tag) + "' the core never asked for");
+            return Step::kDiverged;
+        }
+    }
+
+    bool ReplayWorld::RunNextTask()
+    {
+        if (_tasks.empty()) {
+            Fail("capture ran a task the core never queued");
+            return false;
+        }
+
+        auto fn = std::move(_tasks.front());
+        _tasks.pop_front();
+        fn();
+        return !_diverged;
+    }
+
+    SettingsPtr ReplayWorld::AcquireSettings()
+    {
+        std::uint8_t tag = 0;
+        if (!_diverged && !_ended && Read(tag)) {
+            if (tag == static_cast<std::uint8_t>(Tag::kSettings)) {
+                auto settings = std::make_shared<Settings>();
+                if (Read(*settings)) {
+                    _settings = std::move(settings);
+                }
+            }
+            else if (tag != static_cast<std::uint8_t>(Tag::kSettingsSame) || !_settings) {
+                Fail(std::string("core asked for settings, capture has record '") + static_cast<char>(tag) + "'");
+            }
+        }
+
+        // Past a divergence or the end, keep the core going on something sane; the driver
+        // stops at the next event.
+        return _settings ? _settings : std::make_shared<Settings>();
+    }
+
+    bool ReplayWorld::GetActorState(ActorId id, ActorState& out) const
+    {
+        if (!Expect(Tag::kActorState, "actor state")) {
+            return false;
+        }
+
+        ActorId recorded = 0;
+        std::uint8_t ok = 0;
+        std::uint8_t dead = 0;
+        std::uint8_t player = 0;
+        if (!Read(recorded) || !Read(ok) || !Read(out.position.x) || !Read(out.position.y) || !Read(out.position.z) ||
+            !Read(dead) || !Read(player) || !Read(out.race)) {
+            return false;
+        }
+        if (recorded != id) {
+            Fail("actor state for a different actor");
+            return false;
+        }
+
+        out.dead = dead != 0;
+        out.player = player != 0;
+        return ok != 0;
+    }
+
+    bool ReplayWorld::IsAttacking(ActorId id) const
+    {
+        return ExpectIdBool(Tag::kAttacking, id, "attack state");
+    }
+
+    bool ReplayWorld::IsValidTarget(const Settings&, ActorId target) const
+    {
+        return ExpectIdBool(Tag::kValidTarget, target, "target filter");
+    }
+
+    bool ReplayWorld::SuppressedByFirstPerson(const Settings&, ActorId aggressor) const
+    {
+        return ExpectIdBool(Tag::kFirstPerson, aggressor, "camera state");
+    }
+
+    bool ReplayWorld::GetCameraPosition(Vec3& out) const
+    {
+        if (!Expect(Tag::kCamera, "camera position")) {
+            return false;
+        }
+
+        std::uint8_t ok = 0;
+        if (!Read(ok) || !Read(out.x) || !Read(out.y) || !Read(out.z)) {
+            return false;
+        }
+        return ok != 0;
+    }
+
+    bool ReplayWorld::Watch(ActorId id)
+    {
+        return ExpectIdBool(Tag::kWatch, id, "an attack watch");
+    }
+
+    void ReplayWorld::Drain(std::vector<AttackEvent>& out)
+    {
+        if (!Expect(Tag::kAttackEvents, "attack events")) {
+            return;
+        }
+
+        std::uint32_t count = 0;
+        if (!Read(count)) {
+            return;
+        }
+        for (std::uint32_t i = 0; i < count; ++i) {
+            AttackEvent event{};
+            std::uint8_t kind = 0;
+            if (!Read(event.actor) || !Read(kind)) {
+                return;
+            }
+            event.kind = static_cast<AttackEventKind>(kind);
+            out.push_back(event);
+        }
+    }
+
+    bool ReplayWorld::ApplyCurrent(ActorId target, const Vec3& velocity, float duration)
+    {
+        if (!Expect(Tag::kApplyCurrent, "ApplyCurrent")) {
+            return false;
+        }
+
+        ActorId recorded = 0;
+        Vec3 v{};
+        float dur = 0.0f;
+        std::uint8_t ok = 0;
+        if (!Read(recorded) || !Read(v.x) || !Read(v.y) || !Read(v.z) || !Read(dur) || !Read(ok)) {
+            return false;
+        }
+        if (recorded != target) {
+            Fail("ApplyCurrent on a different actor");
+            return false;
+        }
+
+        // Another compiler or SIMD path may round differently; anything beyond that is a real change.
+        const float delta = std::max({ std::fabs(v.x - velocity.x), std::fabs(v.y - velocity.y),
+            std::fabs(v.z - velocity.z), std::fabs(dur - duration) });
+        _maxApplyDelta = std::max(_maxApplyDelta, delta);
+        const float scale = std::max({ 1.0f, std::fabs(v.x), std::fabs(v.y), std::fabs(dur) });
+        if (delta > 1e-4f * scale) {
+            Fail("ApplyCurrent velocity/duration differ");
+            return false;
+        }
+
+        ++_applyCurrentCalls;
+        return ok != 0;
+    }
+
+    bool ReplayWorld::AddTask(std::function<void()> fn)
+    {
+        if (!Expect(Tag::kAddTask, "a task slot")) {
+            return false;
+        }
+
+        std::uint8_t ok = 0;
+        if (!Read(ok)) {
+            return false;
+        }
+        if (ok) {
+            _tasks.push_back(std::move(fn));
+        }
+        return ok != 0;
+    }
+}
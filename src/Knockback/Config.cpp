@@ -1,101 +1,82 @@
 #include <Knockback/Config.h>
+#include <Knockback/ConfigCache.h>
+#include <Knockback/ConfigWatcher.h>
+#include <Knockback/Filters.h>
+#include <Knockback/FormSpecs.h>
+#include <Knockback/GameWorld.h>
+#include <Knockback/Ini.h>
+#include <Knockback/Log.h>
+#include <Knockback/SettingsSchema.h>
 
 #include "SKSE/SKSE.h"
-#include "SimpleIni.h"
 
 #include <RE/T/TESDataHandler.h>
 #include <algorithm>
-#include <cctype>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <format>
+#include <fstream>
+#include <future>
+#include <memory_resource>
 #include <string>
 #include <string_view>
+#include <system_error>
 #include <vector>
 #include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
 
 
 namespace logger = SKSE::log;
 
 namespace Knockback
 {
-    static Config g_cfg{};
     namespace fs = std::filesystem;
 
-    static std::mutex g_cfgMutex{};
-    static fs::file_time_type g_lastWriteTime{};
-    static std::string g_lastPath{};
-    static std::chrono::steady_clock::time_point g_lastCheck{};
-    static fs::file_time_type g_lastLegacyWriteTime{};
-    static fs::file_time_type g_lastMcmWriteTime{};
-    static bool g_lastLegacyExists{ false };
-    static bool g_lastMcmExists{ false };
-
-    const Config& GetConfig()
-    {
-        return g_cfg;
-    }
+    // Default archetype keywords (used when [Archetypes] is empty or missing)
+    constexpr RE::FormID kKW_ActorTypeNPC = 0x00013794;               // ActorTypeNPC
+    constexpr RE::FormID kKW_ActorTypeUndead = 0x00013796;            // ActorTypeUndead
+    constexpr RE::FormID kKW_ActorTypeDragon = 0x00035D59;            // ActorTypeDragon
+    constexpr RE::FormID kKW_ActorTypeGiant = 0x0010E984;             // ActorTypeGiant
 
-    static std::string Trim(std::string s)
-    {
-        auto is_space = [](unsigned char c) { return std::isspace(c) != 0; };
+    // Published snapshots are immutable and reference counted: readers pin one with
+    // AcquireConfig, writers swap in a new one under g_cfgMutex. A replaced snapshot is
+    // freed when its last reader lets go of it.
+    static const Config g_defaultCfg{};
+    static std::atomic<std::shared_ptr<const Config>> g_snapshot{};
+    static std::uint64_t g_epoch{ 0 };
 
-        s.erase(s.begin(), std::find_if(s.begin(), s.end(), [&](char c) { return !is_space((unsigned char)c); }));
-        s.erase(std::find_if(s.rbegin(), s.rend(), [&](char c) { return !is_space((unsigned char)c); }).base(), s.end());
-        return s;
-    }
+    static std::mutex g_cfgMutex{};
+    // Serializes whole loads (startup vs. watcher thread); publication has its own lock.
+    static std::mutex g_loadMutex{};
 
-    static std::string StripIniComment(std::string s)
+    ConfigPtr AcquireConfig()
     {
-        const auto pos = s.find_first_of(";#");
-        if (pos != std::string::npos) {
-            s.erase(pos);
+        if (auto snap = g_snapshot.load(std::memory_order_acquire)) {
+            return snap;
         }
-        return Trim(std::move(s));
+        // Nothing published yet: hand out the defaults without taking ownership.
+        return ConfigPtr(std::shared_ptr<const Config>{}, &g_defaultCfg);
     }
 
-    static std::vector<std::string> SplitCSV(std::string_view csv)
+    std::uint64_t GetConfigEpoch()
     {
-        std::vector<std::string> out;
-        std::string cur;
-        for (char c : csv) {
-            if (c == ',') {
-                cur = StripIniComment(std::move(cur));
-                if (!cur.empty()) {
-                    out.push_back(std::move(cur));
-                }
-                cur.clear();
-            }
-            else {
-                cur.push_back(c);
-            }
-        }
-
-        cur = StripIniComment(std::move(cur));
-        if (!cur.empty()) {
-            out.push_back(std::move(cur));
-        }
-        return out;
+        return AcquireConfig()->epoch;
     }
 
-    static std::string NormalizeHexToken(std::string hex)
+    static ConfigPtr PublishConfig(Config&& cfg)
     {
-        hex = Trim(std::move(hex));
+        std::scoped_lock lock(g_cfgMutex);
 
-        if (hex.rfind("FormID:", 0) == 0) {
-            hex = Trim(hex.substr(6));
-        }
-        if (hex.rfind("0x", 0) == 0 || hex.rfind("0X", 0) == 0) {
-            hex = Trim(hex.substr(2));
-        }
-        return hex;
-    }
-
-    static bool LoadIniFile(CSimpleIniA& ini, const std::string& path)
-    {
-        ini.Reset();
-        ini.SetUnicode();
-        ini.SetMultiKey();
-        return ini.LoadFile(path.c_str()) >= 0;
+        cfg.epoch = ++g_epoch;
+        ConfigPtr snap = std::make_shared<const Config>(std::move(cfg));
+        g_snapshot.store(snap, std::memory_order_release);
+        return snap;
     }
 
     static std::string GetMcmSettingsPath()
@@ -115,409 +96,433 @@ namespace Knockback
     }
 
 
-    static RE::FormID ParseFormSpec(const std::string& spec)
+    // The active load order for FormSpecs::Batch. LookupModByName walks the whole file list,
+    // so the batch calls this once per distinct plugin rather than once per entry.
+    class LoadOrder final : public FormSpecs::IPluginTable
     {
-        const auto cleaned = StripIniComment(spec);
-        const auto bar = cleaned.find('|');
-        if (bar == std::string::npos) {
-            return 0;
-        }
-
-        std::string file = Trim(cleaned.substr(0, bar));
-        std::string hex = NormalizeHexToken(cleaned.substr(bar + 1));
-
-        if (file.empty() || hex.empty()) {
-            return 0;
-        }
-
-        std::uint32_t localID = 0;
-        try {
-            localID = static_cast<std::uint32_t>(std::stoul(hex, nullptr, 16));
-        }
-        catch (...) {
-            return 0;
+    public:
+        std::optional<FormSpecs::PluginSlot> Find(std::string_view name) const override
+        {
+            auto* data = RE::TESDataHandler::GetSingleton();
+            const auto* file = data ? data->LookupModByName(name) : nullptr;
+            if (!file || file->compileIndex == 0xFF) {
+                return std::nullopt;
+            }
+            if (file->compileIndex == 0xFE) {
+                return FormSpecs::PluginSlot{ file->smallFileCompileIndex, true };
+            }
+            return FormSpecs::PluginSlot{ file->compileIndex, false };
         }
+    };
 
-        auto* data = RE::TESDataHandler::GetSingleton();
-        if (!data) {
-            return 0;
+    static fs::path GetConfigCachePath()
+    {
+        // Next to the log: a per-user location that is safe to write and to delete.
+        auto logsFolder = SKSE::log::log_directory();
+        if (!logsFolder) {
+            return {};
         }
+        return *logsFolder / std::format("{}.configcache", SKSE::PluginDeclaration::GetSingleton()->GetName());
+    }
 
-        const RE::FormID fullID = data->LookupFormID(localID, file);
-        if (!fullID) {
-            logger::warn("LookupFormID failed: file='{}' localID=0x{:08X}", file, localID);
-        }
-        return fullID;
+    static std::int64_t MicrosSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
     }
 
-    static void SeedMcmFromLegacyIfMissing(const std::string& legacyPath, const std::string& mcmPath)
+    // Game-dependent tail shared by the cached and full load paths.
+    static ConfigPtr CommitConfig(Config&& tmp)
     {
-        namespace fs = std::filesystem;
+        BuildTargetTables(tmp);
+        auto snap = PublishConfig(std::move(tmp));
+        SetBinaryTrace(snap->asyncBinaryTrace);
+        SetStatsInterval(snap->statsIntervalSeconds);
+        SetCaptureTrace(snap->captureTrace);
+        return snap;
+    }
 
-        // If the MCM settings file already exists, do not overwrite user choices.
+    // Writes the MCM settings file from the legacy values the first time around; never
+    // touches an existing one, so user choices made in the MCM stick. Written to a temp file
+    // and renamed into place, so the MCM framework never reads a half-written file.
+    static void SeedMcmFromLegacyIfMissing(const Ini::Document& legacy, const std::string& mcmPath)
+    {
         if (fs::exists(mcmPath)) {
             return;
         }
 
-        CSimpleIniA legacy;
-        legacy.SetUnicode();
-        legacy.SetMultiKey();
-        if (legacy.LoadFile(legacyPath.c_str()) < 0) {
-            // No legacy file -> nothing to seed.
-            return;
+        // Compiled defaults for whatever the legacy file leaves out.
+        Settings seed{};
+        Schema::Apply(legacy, Schema::Layer::kLegacy, seed);
+        const auto text = Schema::FormatMcm(seed);
+
+        std::error_code ec;
+        fs::create_directories(fs::path(mcmPath).parent_path(), ec);
+
+        auto tmpPath = fs::path(mcmPath);
+        tmpPath += ".tmp";
+        {
+            std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+            out.write(text.data(), static_cast<std::streamsize>(text.size()));
+            if (!out) {
+                logger::warn("Could not write MCM settings: {}", tmpPath.string());
+                return;
+            }
+        }
+        fs::rename(tmpPath, mcmPath, ec);
+        if (ec) {
+            logger::warn("Could not create MCM settings {}: {}", mcmPath, ec.message());
+            fs::remove(tmpPath, ec);
         }
-
-        CSimpleIniA mcm;
-        mcm.SetUnicode();
-        mcm.SetMultiKey();
-
-        // ---- General ----
-        // Use the same defaults as Config{} so the seed matches compiled defaults when legacy key is absent.
-        // Floats
-        const double shoveMagnitude = legacy.GetDoubleValue("General", "ShoveMagnitude", 2.5);
-        const double shoveDuration = legacy.GetDoubleValue("General", "ShoveDuration", 0.12);
-        const double minShoveSeparationDelta = legacy.GetDoubleValue("General", "MinShoveSeparationDelta", 8.0);
-        const double applyCurrentMinVelocity = legacy.GetDoubleValue("General", "ApplyCurrentMinVelocity", 4.0);
-        const double minDurationScale = legacy.GetDoubleValue("General", "MinDurationScale", 0.15);
-
-        const double minSeparationDistance = legacy.GetDoubleValue("General", "MinSeparationDistance", 110.0);
-        const double separationPushDuration = legacy.GetDoubleValue("General", "SeparationPushDuration", 0.10);
-        const double separationMaxVelocity = legacy.GetDoubleValue("General", "SeparationMaxVelocity", 10.0);
-
-        // Ints
-        const long shoveRetries = legacy.GetLongValue("General", "ShoveRetries", 3);
-        const long shoveRetryDelayFrames = legacy.GetLongValue("General", "ShoveRetryDelayFrames", 1);
-        const long shoveInitialDelayFrames = legacy.GetLongValue("General", "ShoveInitialDelayFrames", 1);
-
-        const long separationRetries = legacy.GetLongValue("General", "SeparationRetries", 6);
-        const long separationInitialDelay = legacy.GetLongValue("General", "SeparationInitialDelayFrames", 1);
-        const long separationRetryDelay = legacy.GetLongValue("General", "SeparationRetryDelayFrames", 1);
-
-        // Bools
-        const bool disableInFirstPerson = legacy.GetBoolValue("General", "DisableInFirstPerson", true);
-        const bool enforceMinSeparation = legacy.GetBoolValue("General", "EnforceMinSeparation", true);
-
-        // Write keys that your MCM JSON / your MCM override loader expects (prefixed)
-        mcm.SetDoubleValue("General", "fShoveMagnitude", shoveMagnitude);
-        mcm.SetDoubleValue("General", "fShoveDuration", shoveDuration);
-        mcm.SetDoubleValue("General", "fMinShoveSeparationDelta", minShoveSeparationDelta);
-        mcm.SetDoubleValue("General", "fApplyCurrentMinVelocity", applyCurrentMinVelocity);
-        mcm.SetDoubleValue("General", "fMinDurationScale", minDurationScale);
-
-        mcm.SetLongValue("General", "iShoveRetries", shoveRetries);
-        mcm.SetLongValue("General", "iShoveRetryDelayFrames", shoveRetryDelayFrames);
-        mcm.SetLongValue("General", "iShoveInitialDelayFrames", shoveInitialDelayFrames);
-
-        mcm.SetBoolValue("General", "bDisableInFirstPerson", disableInFirstPerson);
-
-        mcm.SetBoolValue("General", "bEnforceMinSeparation", enforceMinSeparation);
-        mcm.SetDoubleValue("General", "fMinSeparationDistance", minSeparationDistance);
-        mcm.SetDoubleValue("General", "fSeparationPushDuration", separationPushDuration);
-        mcm.SetDoubleValue("General", "fSeparationMaxVelocity", separationMaxVelocity);
-        mcm.SetLongValue("General", "iSeparationRetries", separationRetries);
-        mcm.SetLongValue("General", "iSeparationInitialDelayFrames", separationInitialDelay);
-        mcm.SetLongValue("General", "iSeparationRetryDelayFrames", separationRetryDelay);
-
-        // ---- WeaponMultipliers (only the ones you expose/read from MCM) ----
-        const double unarmed = legacy.GetDoubleValue("WeaponMultipliers", "Unarmed", 0.85);
-        const double powerAttack = legacy.GetDoubleValue("WeaponMultipliers", "PowerAttack", 1.2);
-
-        mcm.SetDoubleValue("WeaponMultipliers", "fUnarmed", unarmed);
-        mcm.SetDoubleValue("WeaponMultipliers", "fPowerAttack", powerAttack);
-
-        // Ensure directory exists and write the file
-        fs::create_directories(fs::path(mcmPath).parent_path());
-        mcm.SaveFile(mcmPath.c_str());
     }
 
-
-    void LoadConfig()
+    // Leading number of a weapon multiplier value, as the std::stof it replaces read it.
+    static bool ParseMultiplier(std::string_view value, float& out)
     {
-        Config tmp{};
-
-        const auto pluginName = SKSE::PluginDeclaration::GetSingleton()->GetName();
-        const auto legacyPath = GetLegacyPath(pluginName);
-        const auto mcmPath = GetMcmSettingsPath();
-
-        CSimpleIniA legacyIni;
-        CSimpleIniA mcmIni;
+        if (!value.empty() && value.front() == '+') {
+            value.remove_prefix(1);
+        }
+        double mult = 0.0;
+        const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), mult);
+        if (ec != std::errc{}) {
+            return false;
+        }
+        out = static_cast<float>(mult);
+        return true;
+    }
 
-        const bool haveLegacy = fs::exists(legacyPath) && LoadIniFile(legacyIni, legacyPath);
-        bool haveMcm = fs::exists(mcmPath) && LoadIniFile(mcmIni, mcmPath);
+    // Everything a load reads from disk, before anything is looked up in the game: the MCM
+    // file seeded, the schema fields of both INI files applied and clamped and every FormSpec
+    // queued (with its own copy of the text). The files themselves are closed by the time
+    // ParseConfig returns. The first one is built on a worker thread at plugin load and
+    // reloads are built on the watcher thread; ResolveConfig finishes each on the main thread.
+    struct ParsedConfig
+    {
+        using Handle = FormSpecs::Batch::Handle;
+
+        // Both files' entry lists and the FormSpec tables share one arena that is thrown
+        // away with the load.
+        std::array<std::byte, 16 * 1024> arenaBuffer;
+        std::pmr::monotonic_buffer_resource arena{ arenaBuffer.data(), arenaBuffer.size() };
+
+        FormSpecs::Batch specs{ &arena };
+        std::pmr::vector<std::pair<Handle, float>> keywordSpecs{ &arena };
+        std::pmr::vector<Handle> allowRaceSpecs{ &arena };
+        std::pmr::vector<Handle> denyRaceSpecs{ &arena };
+        std::pmr::vector<Handle> allowArchetypeSpecs{ &arena };
+        std::pmr::vector<Handle> denyArchetypeSpecs{ &arena };
+
+        Config config{};
+        std::string legacyPath;
+        std::string mcmPath;
+        bool haveLegacy{ false };
+        bool haveMcm{ false };
+        std::uint64_t inputsHash{ 0 };   // ConfigCache::HashInputs of the parsed bytes
+
+        std::int64_t parseMicros{ 0 };
+        std::int64_t seedMicros{ 0 };
+    };
+
+    static std::unique_ptr<ParsedConfig> ParseConfig()
+    {
+        const auto started = std::chrono::steady_clock::now();
+        auto parsed = std::make_unique<ParsedConfig>();
+        auto& p = *parsed;
+
+        p.legacyPath = GetLegacyPath(SKSE::PluginDeclaration::GetSingleton()->GetName());
+        p.mcmPath = GetMcmSettingsPath();
+
+        // Mapped only for the length of this function: MCM Helper or an editor may want to
+        // save them before the load is resolved.
+        Ini::Document legacyIni{ &p.arena };
+        Ini::Document mcmIni{ &p.arena };
+
+        p.haveLegacy = legacyIni.Load(p.legacyPath);
+        if (p.haveLegacy) {
+            const auto seedStarted = std::chrono::steady_clock::now();
+            SeedMcmFromLegacyIfMissing(legacyIni, p.mcmPath);
+            p.seedMicros = MicrosSince(seedStarted);
+        }
+        p.haveMcm = mcmIni.Load(p.mcmPath);
 
-        if (!haveLegacy) {
-            logger::warn("Legacy config not found or failed to load: {}", legacyPath);
+        if (!p.haveLegacy) {
+            logger::warn("Legacy config not found or failed to load: {}", p.legacyPath);
             logger::warn("Using compiled defaults for advanced lists (WeaponMultipliers/Races).");
         }
         else {
-            logger::info("Loaded legacy config: {}", legacyPath);
+            logger::info("Loaded legacy config: {}", p.legacyPath);
         }
 
-        if (haveMcm) {
-            logger::info("Loaded MCM settings: {}", mcmPath);
+        if (p.haveMcm) {
+            logger::info("Loaded MCM settings: {}", p.mcmPath);
         }
         else {
-            logger::info("MCM settings not present yet: {}", mcmPath);
+            logger::info("MCM settings not present yet: {}", p.mcmPath);
         }
 
         // -----------------------------
-        // 1) Apply LEGACY (base layer)
+        // 1) Apply LEGACY (base layer): every schema field; queue the form tables' FormSpecs
         // -----------------------------
-        auto& iniBase = haveLegacy ? legacyIni : mcmIni; // fallback if you *only* have MCM (rare)
-
-        // General from legacy (non-prefixed keys)
-        if (haveLegacy) {
-            tmp.shoveMagnitude = static_cast<float>(legacyIni.GetDoubleValue("General", "ShoveMagnitude", tmp.shoveMagnitude));
-            tmp.shoveDuration = static_cast<float>(legacyIni.GetDoubleValue("General", "ShoveDuration", tmp.shoveDuration));
-
-            tmp.shoveRetries = static_cast<std::int32_t>(legacyIni.GetLongValue("General", "ShoveRetries", tmp.shoveRetries));
-            tmp.shoveRetryDelayFrames = static_cast<std::int32_t>(legacyIni.GetLongValue("General", "ShoveRetryDelayFrames", tmp.shoveRetryDelayFrames));
-
-            tmp.shoveInitialDelayFrames = static_cast<std::int32_t>(legacyIni.GetLongValue("General", "ShoveInitialDelayFrames", tmp.shoveInitialDelayFrames));
-            tmp.minShoveSeparationDelta = static_cast<float>(legacyIni.GetDoubleValue("General", "MinShoveSeparationDelta", tmp.minShoveSeparationDelta));
-
-            tmp.disableInFirstPerson = legacyIni.GetBoolValue("General", "DisableInFirstPerson", tmp.disableInFirstPerson);
-            tmp.applyCurrentMinVelocity = static_cast<float>(legacyIni.GetDoubleValue("General", "ApplyCurrentMinVelocity", tmp.applyCurrentMinVelocity));
-            tmp.minDurationScale = static_cast<float>(legacyIni.GetDoubleValue("General", "MinDurationScale", tmp.minDurationScale));
-
-            tmp.enforceMinSeparation = legacyIni.GetBoolValue("General", "EnforceMinSeparation", tmp.enforceMinSeparation);
-            tmp.minSeparationDistance = static_cast<float>(legacyIni.GetDoubleValue("General", "MinSeparationDistance", tmp.minSeparationDistance));
-            tmp.separationPushDuration = static_cast<float>(legacyIni.GetDoubleValue("General", "SeparationPushDuration", tmp.separationPushDuration));
-            tmp.separationMaxVelocity = static_cast<float>(legacyIni.GetDoubleValue("General", "SeparationMaxVelocity", tmp.separationMaxVelocity));
-            tmp.separationRetries = static_cast<std::int32_t>(legacyIni.GetLongValue("General", "SeparationRetries", tmp.separationRetries));
-            tmp.separationInitialDelayFrames = static_cast<std::int32_t>(legacyIni.GetLongValue("General", "SeparationInitialDelayFrames", tmp.separationInitialDelayFrames));
-            tmp.separationRetryDelayFrames = static_cast<std::int32_t>(legacyIni.GetLongValue("General", "SeparationRetryDelayFrames", tmp.separationRetryDelayFrames));
-        }
-
-        // Weapon multipliers + races ALWAYS from legacy
-        std::size_t parsed = 0;
-        std::size_t resolved = 0;
+        if (p.haveLegacy) {
+            Schema::Apply(legacyIni, Schema::Layer::kLegacy, p.config);
 
-        if (haveLegacy) {
-            tmp.weaponTypeMultipliers.clear();
-            tmp.weaponTypeKeywordMultipliers.clear();
-
-            // Unarmed base from legacy (can be overridden later by MCM)
-            tmp.unarmedMultiplier = static_cast<float>(
-                legacyIni.GetDoubleValue("WeaponMultipliers", "Unarmed", tmp.unarmedMultiplier));
-            tmp.powerAttackMultiplier = static_cast<float>(
-                legacyIni.GetDoubleValue("WeaponMultipliers", "PowerAttack", tmp.powerAttackMultiplier));
+            auto add = [&p](std::string_view spec, auto& out) {
+                if (const auto h = p.specs.Add(spec); h != FormSpecs::Batch::kInvalid) out.push_back(h);
+            };
 
-            CSimpleIniA::TNamesDepend keys;
-            legacyIni.GetAllKeys("WeaponMultipliers", keys);
+            for (const auto& e : legacyIni.Entries()) {
+                if (Ini::IEquals(e.section, "WeaponMultipliers")) {
+                    // Unarmed and PowerAttack are schema fields; every other key is a FormSpec.
+                    if (Ini::IEquals(e.key, "Unarmed") || Ini::IEquals(e.key, "PowerAttack")) continue;
 
-            for (const auto& k : keys) {
-                if (!k.pItem) continue;
+                    float mult = 1.0f;
+                    if (!ParseMultiplier(e.value, mult) || !(mult > 0.0f)) continue;
 
-                std::string_view key{ k.pItem };
-                if (_stricmp(key.data(), "Unarmed") == 0) continue;
-                if (_stricmp(key.data(), "PowerAttack") == 0) continue;
+                    if (const auto h = p.specs.Add(e.key); h != FormSpecs::Batch::kInvalid) p.keywordSpecs.emplace_back(h, mult);
+                }
+                else if (Ini::IEquals(e.section, "Races")) {
+                    if (Ini::IEquals(e.key, "Allow")) add(e.value, p.allowRaceSpecs);
+                    else if (Ini::IEquals(e.key, "Deny")) add(e.value, p.denyRaceSpecs);
+                }
+                else if (Ini::IEquals(e.section, "Archetypes")) {
+                    if (Ini::IEquals(e.key, "Allow")) add(e.value, p.allowArchetypeSpecs);
+                    else if (Ini::IEquals(e.key, "Deny")) add(e.value, p.denyArchetypeSpecs);
+                }
+            }
+        }
 
-                const char* valStr = legacyIni.GetValue("WeaponMultipliers", k.pItem, nullptr);
-                if (!valStr) continue;
+        // -----------------------------
+        // 2) Apply MCM overrides (the schema's MCM fields ONLY)
+        // -----------------------------
+        if (p.haveMcm) {
+            Schema::Apply(mcmIni, Schema::Layer::kMcm, p.config);
+        }
 
-                float mult = 1.0f;
-                try { mult = std::stof(valStr); }
-                catch (...) { continue; }
+        Schema::Clamp(p.config);
 
-                if (!(mult > 0.0f)) continue;
+        // The bytes that were parsed, while still mapped; the MCM file was loaded after
+        // seeding, so a freshly created one is part of the fingerprint.
+        p.inputsHash = ConfigCache::HashInputs({ legacyIni.Text(), mcmIni.Text() });
+        p.parseMicros = MicrosSince(started);
+        return parsed;
+    }
 
-                const auto formID = ParseFormSpec(std::string(key));
-                if (!formID) continue;
+    // The half of a load that needs the game's data: resolves the queued FormSpecs against
+    // the load order and fills the form tables. Main thread at startup (kDataLoaded).
+    static void ResolveConfig(ParsedConfig& p, std::size_t& parsed, std::size_t& resolved)
+    {
+        auto& tmp = p.config;
+
+        if (p.haveLegacy) {
+            // Each plugin is looked up once and all IDs computed together; what did not
+            // resolve is reported in one line.
+            auto& specs = p.specs;
+            specs.Resolve(LoadOrder{});
+
+            auto keyword = [&specs](FormSpecs::Batch::Handle h) -> RE::BGSKeyword* {
+                const auto id = specs.FormID(h);
+                if (!id) return nullptr;
+                auto* kw = RE::TESForm::LookupByID<RE::BGSKeyword>(id);
+                if (!kw) specs.Reject(h);
+                return kw;
+            };
 
+            std::vector<std::pair<RE::BGSKeyword*, float>> keywordMults;
+            keywordMults.reserve(p.keywordSpecs.size());
+            for (const auto& [h, mult] : p.keywordSpecs) {
+                if (!specs.FormID(h)) continue;
                 ++parsed;
-                tmp.weaponTypeMultipliers[formID] = mult;
-
-                auto* kw = RE::TESForm::LookupByID<RE::BGSKeyword>(formID);
-                if (!kw) continue;
-
-                tmp.weaponTypeKeywordMultipliers[kw] = mult;
-                ++resolved;
+                if (auto* kw = keyword(h)) {
+                    keywordMults.emplace_back(kw, mult);
+                    ++resolved;
+                }
             }
 
-            // Races
-            {
-                CSimpleIniA::TNamesDepend allowVals;
-                CSimpleIniA::TNamesDepend denyVals;
-
-                legacyIni.GetAllValues("Races", "Allow", allowVals);
-                legacyIni.GetAllValues("Races", "Deny", denyVals);
-
-                for (const auto& v : allowVals) {
-                    if (!v.pItem) continue;
-                    if (const auto id = ParseFormSpec(v.pItem); id != 0) tmp.allowRaces.insert(id);
-                }
-                for (const auto& v : denyVals) {
-                    if (!v.pItem) continue;
-                    if (const auto id = ParseFormSpec(v.pItem); id != 0) tmp.denyRaces.insert(id);
+            auto raceIDs = [&specs](const auto& handles) {
+                std::vector<RE::FormID> ids;
+                ids.reserve(handles.size());
+                for (const auto h : handles) {
+                    if (const auto id = specs.FormID(h); id != 0) ids.push_back(id);
                 }
-            }
-        }
-        SeedMcmFromLegacyIfMissing(legacyPath, mcmPath);
-        haveMcm = fs::exists(mcmPath) && LoadIniFile(mcmIni, mcmPath);
+                return ids;
+            };
 
-        // -----------------------------
-        // 2) Apply MCM overrides (General + Unarmed ONLY)
-        // -----------------------------
-        if (haveMcm) {
-            auto getFloat = [&](const char* section, const char* keyNew, const char* keyOld, float cur) -> float {
-                if (mcmIni.KeyExists(section, keyNew)) return static_cast<float>(mcmIni.GetDoubleValue(section, keyNew, cur));
-                if (mcmIni.KeyExists(section, keyOld)) return static_cast<float>(mcmIni.GetDoubleValue(section, keyOld, cur));
-                return cur;
-                };
-            auto getInt = [&](const char* section, const char* keyNew, const char* keyOld, std::int32_t cur) -> std::int32_t {
-                if (mcmIni.KeyExists(section, keyNew)) return static_cast<std::int32_t>(mcmIni.GetLongValue(section, keyNew, cur));
-                if (mcmIni.KeyExists(section, keyOld)) return static_cast<std::int32_t>(mcmIni.GetLongValue(section, keyOld, cur));
-                return cur;
-                };
-            auto getBool = [&](const char* section, const char* keyNew, const char* keyOld, bool cur) -> bool {
-                if (mcmIni.KeyExists(section, keyNew)) return mcmIni.GetBoolValue(section, keyNew, cur);
-                if (mcmIni.KeyExists(section, keyOld)) return mcmIni.GetBoolValue(section, keyOld, cur);
-                return cur;
-                };
-
-            tmp.shoveMagnitude = getFloat("General", "fShoveMagnitude", "ShoveMagnitude", tmp.shoveMagnitude);
-            tmp.shoveDuration = getFloat("General", "fShoveDuration", "ShoveDuration", tmp.shoveDuration);
-
-            tmp.shoveRetries = getInt("General", "iShoveRetries", "ShoveRetries", tmp.shoveRetries);
-            tmp.shoveRetryDelayFrames = getInt("General", "iShoveRetryDelayFrames", "ShoveRetryDelayFrames", tmp.shoveRetryDelayFrames);
-
-            tmp.shoveInitialDelayFrames = getInt("General", "iShoveInitialDelayFrames", "ShoveInitialDelayFrames", tmp.shoveInitialDelayFrames);
-            tmp.minShoveSeparationDelta = getFloat("General", "fMinShoveSeparationDelta", "MinShoveSeparationDelta", tmp.minShoveSeparationDelta);
-
-            tmp.disableInFirstPerson = getBool("General", "bDisableInFirstPerson", "DisableInFirstPerson", tmp.disableInFirstPerson);
-            tmp.applyCurrentMinVelocity = getFloat("General", "fApplyCurrentMinVelocity", "ApplyCurrentMinVelocity", tmp.applyCurrentMinVelocity);
-            tmp.minDurationScale = getFloat("General", "fMinDurationScale", "MinDurationScale", tmp.minDurationScale);
-
-            tmp.enforceMinSeparation = getBool("General", "bEnforceMinSeparation", "EnforceMinSeparation", tmp.enforceMinSeparation);
-            tmp.minSeparationDistance = getFloat("General", "fMinSeparationDistance", "MinSeparationDistance", tmp.minSeparationDistance);
-            tmp.separationPushDuration = getFloat("General", "fSeparationPushDuration", "SeparationPushDuration", tmp.separationPushDuration);
-            tmp.separationMaxVelocity = getFloat("General", "fSeparationMaxVelocity", "SeparationMaxVelocity", tmp.separationMaxVelocity);
-            tmp.separationRetries = getInt("General", "iSeparationRetries", "SeparationRetries", tmp.separationRetries);
-            tmp.separationInitialDelayFrames = getInt("General", "iSeparationInitialDelayFrames", "SeparationInitialDelayFrames", tmp.separationInitialDelayFrames);
-            tmp.separationRetryDelayFrames = getInt("General", "iSeparationRetryDelayFrames", "SeparationRetryDelayFrames", tmp.separationRetryDelayFrames);
-
-            // Unarmed and PowerAttack override ONLY
-            if (mcmIni.KeyExists("WeaponMultipliers", "fUnarmed")) {
-                tmp.unarmedMultiplier = static_cast<float>(
-                    mcmIni.GetDoubleValue("WeaponMultipliers", "fUnarmed", tmp.unarmedMultiplier));
-            }
-            else if (mcmIni.KeyExists("WeaponMultipliers", "Unarmed")) {
-                tmp.unarmedMultiplier = static_cast<float>(
-                    mcmIni.GetDoubleValue("WeaponMultipliers", "Unarmed", tmp.unarmedMultiplier));
+            for (const auto h : p.allowArchetypeSpecs) {
+                if (auto* kw = keyword(h)) tmp.allowArchetypeKeywords.push_back(kw);
             }
-            if (mcmIni.KeyExists("WeaponMultipliers", "fPowerAttack")) {
-                tmp.powerAttackMultiplier = static_cast<float>(
-                    mcmIni.GetDoubleValue("WeaponMultipliers", "fPowerAttack", tmp.powerAttackMultiplier));
+            for (const auto h : p.denyArchetypeSpecs) {
+                if (auto* kw = keyword(h)) tmp.denyArchetypeKeywords.push_back(kw);
             }
-            else if (mcmIni.KeyExists("WeaponMultipliers", "PowerAttack")) {
-                tmp.powerAttackMultiplier = static_cast<float>(
-                    mcmIni.GetDoubleValue("WeaponMultipliers", "PowerAttack", tmp.powerAttackMultiplier));
+
+            if (const auto report = specs.Report(); !report.empty()) {
+                logger::warn("Legacy config: {}", report);
             }
-        }
+            logger::info("FormSpecs: {} entries across {} plugins resolved in one batch", specs.Size(), specs.PluginCount());
 
-        // clamps
-        if (tmp.shoveRetries < 0) tmp.shoveRetries = 0;
-        if (tmp.shoveRetries > 10) tmp.shoveRetries = 10;
+            tmp.weaponTypeKeywordMultipliers = FlatMap<RE::BGSKeyword*, float>(std::move(keywordMults));
+            tmp.allowRaces = FlatSet<RE::FormID>(raceIDs(p.allowRaceSpecs));
+            tmp.denyRaces = FlatSet<RE::FormID>(raceIDs(p.denyRaceSpecs));
+        }
 
-        // Publish
-        g_cfg = std::move(tmp);
+        // Archetype defaults match the old hardcoded humanoid heuristic
+        auto addDefaultKeyword = [](std::vector<RE::BGSKeyword*>& out, RE::FormID id) {
+            if (auto* kw = RE::TESForm::LookupByID<RE::BGSKeyword>(id)) {
+                out.push_back(kw);
+            }
+        };
+        if (tmp.allowArchetypeKeywords.empty()) {
+            addDefaultKeyword(tmp.allowArchetypeKeywords, kKW_ActorTypeNPC);
+            addDefaultKeyword(tmp.allowArchetypeKeywords, kKW_ActorTypeUndead);
+        }
+        if (tmp.denyArchetypeKeywords.empty()) {
+            addDefaultKeyword(tmp.denyArchetypeKeywords, kKW_ActorTypeDragon);
+            addDefaultKeyword(tmp.denyArchetypeKeywords, kKW_ActorTypeGiant);
+        }
+    }
 
-        MaybeReloadConfig();
+    // The startup parse, started by BeginConfigLoad and joined by the first LoadConfig.
+    static std::future<std::unique_ptr<ParsedConfig>> g_startupParse{};
 
-        // Watcher state: you should watch BOTH files (see next note)
-        g_lastPath.clear(); // optional: stop using single-path watcher
-        logger::info("Config loaded. Legacy={} MCM={} WeaponMults(parsed={}, resolvedKeywords={}, unarmed={}, powerAttack={})",
-            haveLegacy ? legacyPath : "(none)",
-            haveMcm ? mcmPath : "(none)",
-            parsed, resolved, g_cfg.unarmedMultiplier, g_cfg.powerAttackMultiplier);
+    void BeginConfigLoad()
+    {
+        std::scoped_lock loadLock(g_loadMutex);
+        if (!g_startupParse.valid()) {
+            g_startupParse = std::async(std::launch::async, ParseConfig);
+        }
     }
 
-    void MaybeReloadConfig()
+    // The main-thread half of a load: cache check, form resolution, cache save and publish.
+    // joinMicros >= 0 marks the startup load. Caller holds g_loadMutex.
+    static void FinishLoad(ParsedConfig& parsed, std::chrono::steady_clock::time_point started, std::int64_t joinMicros)
     {
-        using namespace std::chrono;
-
-        // Throttle: check at most once per second
-        const auto now = steady_clock::now();
-        if (now - g_lastCheck < 1s) {
-            return;
+        const auto cachePath = GetConfigCachePath();
+        const auto fingerprint = ConfigCache::WithLoadOrder(parsed.inputsHash);
+
+        // Fast path: same INI bytes and load order as last time -> reuse the resolved result.
+        if (!cachePath.empty()) {
+            Config cached{};
+            if (ConfigCache::TryLoad(cachePath, fingerprint, cached)) {
+                const auto snap = CommitConfig(std::move(cached));
+                const auto& cfg = *snap;
+                logger::info("Config loaded from cache (epoch {}) in {} us: {} Races(table={}) WeaponKeywords={} Archetypes(allow={}, deny={})",
+                    cfg.epoch, MicrosSince(started), cachePath.string(),
+                    cfg.raceTargetFlags.size(), cfg.weaponTypeKeywordMultipliers.size(),
+                    cfg.allowArchetypeKeywords.size(), cfg.denyArchetypeKeywords.size());
+                if (joinMicros >= 0) {
+                    logger::info("Startup config timing: worker parse {} us (MCM seed {} us), kDataLoaded wait {} us, main thread {} us (cache hit)",
+                        parsed.parseMicros, parsed.seedMicros, joinMicros, MicrosSince(started));
+                }
+                return;
+            }
         }
-        g_lastCheck = now;
 
-        const auto pluginName = SKSE::PluginDeclaration::GetSingleton()->GetName();
+        const auto resolveStarted = std::chrono::steady_clock::now();
+        std::size_t parsedMults = 0;
+        std::size_t resolvedMults = 0;
+        ResolveConfig(parsed, parsedMults, resolvedMults);
+        const auto resolveMicros = MicrosSince(resolveStarted);
 
-        const auto legacyPath = GetLegacyPath(pluginName);
-        const auto mcmPath = GetMcmSettingsPath();
+        const auto saveStarted = std::chrono::steady_clock::now();
+        if (!cachePath.empty()) {
+            ConfigCache::Save(cachePath, fingerprint, parsed.config);
+        }
+        const auto saveMicros = MicrosSince(saveStarted);
 
-        auto getState = [](const std::string& path, fs::file_time_type& outWt, std::error_code& outEc) -> bool {
-            outEc.clear();
-            if (!fs::exists(path, outEc) || outEc) {
-                outWt = fs::file_time_type{};
-                return false;
-            }
-            outWt = fs::last_write_time(path, outEc);
-            if (outEc) {
-                outWt = fs::file_time_type{};
-                return false;
-            }
-            return true;
-            };
+        // Publish
+        const auto snap = CommitConfig(std::move(parsed.config));
+        const auto& cfg = *snap;
+        const auto& legacyPath = parsed.legacyPath;
+        const auto& mcmPath = parsed.mcmPath;
+
+        logger::info("Config loaded (epoch {}) in {} us. Legacy={} MCM={} WeaponMults(parsed={}, resolvedKeywords={}, unarmed={}, powerAttack={}) Races(table={}) Archetypes(allow={}, deny={})",
+            cfg.epoch, MicrosSince(started),
+            parsed.haveLegacy ? legacyPath : "(none)",
+            parsed.haveMcm ? mcmPath : "(none)",
+            parsedMults, resolvedMults, cfg.unarmedMultiplier, cfg.powerAttackMultiplier,
+            cfg.raceTargetFlags.size(), cfg.allowArchetypeKeywords.size(), cfg.denyArchetypeKeywords.size());
+        logger::info("Config snapshot tables: allowRaces={} denyRaces={} raceTable={} weaponKeywords={} -> {} bytes",
+            cfg.allowRaces.size(), cfg.denyRaces.size(), cfg.raceTargetFlags.size(),
+            cfg.weaponTypeKeywordMultipliers.size(), cfg.MemoryFootprint());
+        if (joinMicros >= 0) {
+            logger::info("Startup config timing: worker parse {} us (MCM seed {} us), kDataLoaded wait {} us, resolve {} us, cache save {} us, main thread {} us",
+                parsed.parseMicros, parsed.seedMicros, joinMicros, resolveMicros, saveMicros, MicrosSince(started));
+        }
+    }
 
-        fs::file_time_type legacyWt{};
-        fs::file_time_type mcmWt{};
-        std::error_code ecLegacy{};
-        std::error_code ecMcm{};
+    void LoadConfig()
+    {
+        std::scoped_lock loadLock(g_loadMutex);
 
-        const bool legacyExists = getState(legacyPath, legacyWt, ecLegacy);
-        const bool mcmExists = getState(mcmPath, mcmWt, ecMcm);
+        const auto started = std::chrono::steady_clock::now();
 
-        // If the filesystem is erroring, fail silent; don't spam logs.
-        // (But still allow reload if the other file is OK.)
-        if (ecLegacy && ecMcm) {
-            return;
+        // Join the startup parse if one is running; otherwise parse inline.
+        std::unique_ptr<ParsedConfig> parsed;
+        std::int64_t joinMicros = -1;
+        if (g_startupParse.valid()) {
+            parsed = g_startupParse.get();
+            joinMicros = MicrosSince(started);
         }
-
-        // First run initialization: capture current state, dont reload.
-        // (Assumes LoadConfig() already ran during startup.)
-        static bool initialized = false;
-        if (!initialized) {
-            g_lastLegacyExists = legacyExists;
-            g_lastMcmExists = mcmExists;
-            g_lastLegacyWriteTime = legacyWt;
-            g_lastMcmWriteTime = mcmWt;
-            initialized = true;
-            return;
+        else {
+            parsed = ParseConfig();
         }
 
-        // Detect appearance/disappearance or timestamp changes.
-        const bool legacyChanged =
-            (legacyExists != g_lastLegacyExists) ||
-            (legacyExists && legacyWt != g_lastLegacyWriteTime);
+        FinishLoad(*parsed, started, joinMicros);
+    }
 
-        const bool mcmChanged =
-            (mcmExists != g_lastMcmExists) ||
-            (mcmExists && mcmWt != g_lastMcmWriteTime);
+    static std::unique_ptr<ConfigWatcher> g_watcher{};
 
-        if (!legacyChanged && !mcmChanged) {
+    void StartConfigWatcher()
+    {
+        if (g_watcher) {
             return;
         }
 
-        // Update stored state before reload to avoid loops if LoadConfig touches files.
-        g_lastLegacyExists = legacyExists;
-        g_lastMcmExists = mcmExists;
-        g_lastLegacyWriteTime = legacyWt;
-        g_lastMcmWriteTime = mcmWt;
+        const auto pluginName = SKSE::PluginDeclaration::GetSingleton()->GetName();
+        const auto legacyPath = GetLegacyPath(pluginName);
+        const auto mcmPath = GetMcmSettingsPath();
 
-        LoadConfig();
+        // Runs on the watcher thread, which only reads and parses the files. Form lookups,
+        // the cache and the publish (which also reconfigures the trace and stats backends)
+        // are game-side and go to the main thread, as at startup.
+        auto onChange = [legacyPath, mcmPath](std::uint32_t changed) {
+            const auto started = std::chrono::steady_clock::now();
+            std::shared_ptr<ParsedConfig> parsed = ParseConfig();
+
+            const bool queued = GameWorld::GetSingleton().AddTask([parsed, started, changed, legacyPath, mcmPath]() {
+                std::scoped_lock loadLock(g_loadMutex);
+                FinishLoad(*parsed, started, -1);
+
+                const bool legacyChanged = (changed & 1u) != 0;
+                const bool mcmChanged = (changed & 2u) != 0;
+                if (legacyChanged && mcmChanged) {
+                    logger::info("Config reloaded (legacy + MCM changed)");
+                }
+                else if (legacyChanged) {
+                    logger::info("Config reloaded (legacy changed): {}", legacyPath);
+                }
+                else {
+                    logger::info("Config reloaded (MCM changed): {}", mcmPath);
+                }
+            });
+            if (!queued) {
+                logger::warn("Config reload skipped: task interface not available");
+            }
+        };
 
-        if (legacyChanged && mcmChanged) {
-            logger::info("Config reloaded (legacy + MCM changed)");
-        }
-        else if (legacyChanged) {
-            logger::info("Config reloaded (legacy changed): {}", legacyPath);
-        }
-        else {
-            logger::info("Config reloaded (MCM changed): {}", mcmPath);
+        ConfigWatcher::Options opts{};
+        opts.pollInterval = std::chrono::milliseconds(1000);
+        opts.debounce = std::chrono::milliseconds(250);
+
+        g_watcher = std::make_unique<ConfigWatcher>(
+            std::vector<fs::path>{ fs::path(legacyPath), fs::path(mcmPath) }, std::move(onChange), opts);
+        g_watcher->Start();
+        logger::info("Config watcher started");
+    }
+
+    void StopConfigWatcher()
+    {
+        if (g_watcher) {
+            g_watcher->Stop();
+            g_watcher.reset();
         }
     }
 }
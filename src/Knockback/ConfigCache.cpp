@@ -0,0 +1,395 @@
+#include <Knockback/ConfigCache.h>
+#include <Knockback/MappedFile.h>
+
+#include "SKSE/SKSE.h"
+
+#include <RE/T/TESDataHandler.h>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+namespace logger = SKSE::log;
+namespace fs = std::filesystem;
+
+namespace Knockback::ConfigCache
+{
+    namespace
+    {
+        constexpr std::uint32_t kCacheMagic = 0x4343424B;  // 'KBCC'
+        // Bump whenever CachedScalars or the payload layout changes.
+        constexpr std::uint32_t kCacheVersion = 6;
+
+        struct CacheHeader
+        {
+            std::uint32_t magic{ kCacheMagic };
+            std::uint32_t version{ kCacheVersion };
+            std::uint64_t fingerprint{ 0 };
+            std::uint64_t payloadSize{ 0 };
+            std::uint64_t payloadHash{ 0 };
+        };
+        static_assert(sizeof(CacheHeader) == 32);
+
+        // Every non-table Config field, in a fixed padding-free layout.
+        struct CachedScalars
+        {
+            float shoveMagnitude;
+            float shoveDuration;
+            float applyCurrentMinVelocity;
+            float minDurationScale;
+            std::int32_t shoveRetries;
+            std::int32_t shoveRetryDelayFrames;
+            std::int32_t shoveInitialDelayFrames;
+            float minShoveSeparationDelta;
+            float minSeparationDistance;
+            float separationPushDuration;
+            float separationMaxVelocity;
+            std::int32_t separationRetries;
+            std::int32_t separationInitialDelayFrames;
+            std::int32_t separationRetryDelayFrames;
+            float unarmedMultiplier;
+            float powerAttackMultiplier;
+            std::uint8_t disableInFirstPerson;
+            std::uint8_t enforceMinSeparation;
+            std::uint8_t asyncBinaryTrace;
+            std::uint8_t captureTrace;
+            std::int32_t statsIntervalSeconds;
+            std::int32_t adaptiveMinRetries;
+            std::int32_t adaptiveMaxInitialDelayFrames;
+            std::uint8_t adaptiveRetries;
+            std::uint8_t frameBudgetDegrade;
+            std::uint8_t lodFarImpulse;
+            std::uint8_t reserved[1];
+            std::int32_t frameBudgetJobs;
+            std::int32_t frameBudgetMicros;
+            float lodMidDistance;
+            float lodFarDistance;
+        };
+        static_assert(sizeof(CachedScalars) == 100 && std::is_trivially_copyable_v<CachedScalars>);
+
+        struct CachedKeywordMult
+        {
+            RE::FormID keyword;
+            float mult;
+        };
+        static_assert(sizeof(CachedKeywordMult) == 8);
+
+        constexpr std::uint64_t kFnvOffset = 0xCBF29CE484222325ull;
+        constexpr std::uint64_t kFnvPrime = 0x100000001B3ull;
+
+        std::uint64_t Fnv1a(const void* data, std::size_t size, std::uint64_t h = kFnvOffset)
+        {
+            const auto* p = static_cast<const std::uint8_t*>(data);
+            for (std::size_t i = 0; i < size; ++i) {
+                h = (h ^ p[i]) * kFnvPrime;
+            }
+            return h;
+        }
+
+        template <class T>
+        std::uint64_t Fnv1aValue(const T& v, std::uint64_t h)
+        {
+            return Fnv1a(&v, sizeof(T), h);
+        }
+
+        class Reader
+        {
+        public:
+            Reader(const std::uint8_t* data, std::size_t size) :
+                _cur(data),
+                _end(data + size)
+            {}
+
+            template <class T>
+            bool Read(T& out)
+            {
+                if (static_cast<std::size_t>(_end - _cur) < sizeof(T)) {
+                    return false;
+                }
+                std::memcpy(&out, _cur, sizeof(T));
+                _cur += sizeof(T);
+                return true;
+            }
+
+            template <class T>
+            bool ReadArray(std::vector<T>& out)
+            {
+                std::uint32_t count = 0;
+                if (!Read(count) || static_cast<std::size_t>(_end - _cur) / sizeof(T) < count) {
+                    return false;
+                }
+                out.resize(count);
+                if (count) {
+                    std::memcpy(out.data(), _cur, count * sizeof(T));
+                }
+                _cur += count * sizeof(T);
+                return true;
+            }
+
+            bool AtEnd() const { return _cur == _end; }
+
+        private:
+            const std::uint8_t* _cur;
+            const std::uint8_t* _end;
+        };
+
+        class Writer
+        {
+        public:
+            template <class T>
+            void Write(const T& v)
+            {
+                const auto* p = reinterpret_cast<const std::uint8_t*>(&v);
+                _bytes.insert(_bytes.end(), p, p + sizeof(T));
+            }
+
+            template <class T>
+            void WriteArray(const std::vector<T>& v)
+            {
+                Write(static_cast<std::uint32_t>(v.size()));
+                const auto* p = reinterpret_cast<const std::uint8_t*>(v.data());
+                _bytes.insert(_bytes.end(), p, p + v.size() * sizeof(T));
+            }
+
+            std::vector<std::uint8_t>& bytes() { return _bytes; }
+
+        private:
+            std::vector<std::uint8_t> _bytes;
+        };
+
+        std::vector<RE::FormID> KeywordIDs(const std::vector<RE::BGSKeyword*>& kws)
+        {
+            std::vector<RE::FormID> ids;
+            ids.reserve(kws.size());
+            for (const auto* kw : kws) {
+                if (kw) {
+                    ids.push_back(kw->GetFormID());
+                }
+            }
+            return ids;
+        }
+
+        bool ResolveKeywords(const std::vector<RE::FormID>& ids, std::vector<RE::BGSKeyword*>& out)
+        {
+            out.clear();
+            out.reserve(ids.size());
+            for (const auto id : ids) {
+                auto* kw = RE::TESForm::LookupByID<RE::BGSKeyword>(id);
+                if (!kw) {
+                    return false;
+                }
+                out.push_back(kw);
+            }
+            return true;
+        }
+    }
+
+    std::uint64_t HashInputs(std::initializer_list<std::string_view> inputs)
+    {
+        auto h = Fnv1aValue(kCacheVersion, kFnvOffset);
+
+        if (const auto* decl = SKSE::PluginDeclaration::GetSingleton()) {
+            h = Fnv1aValue(decl->GetVersion().pack(), h);
+        }
+
+        for (const auto text : inputs) {
+            h = Fnv1aValue(static_cast<std::uint64_t>(text.size()), h);
+            h = Fnv1a(text.data(), text.size(), h);
+        }
+        return h;
+    }
+
+    std::uint64_t WithLoadOrder(std::uint64_t h)
+    {
+        // FormSpecs resolve against the load order, so any reorder/add/remove invalidates.
+        if (auto* data = RE::TESDataHandler::GetSingleton()) {
+            for (const auto* file : data->files) {
+                if (!file) {
+                    continue;
+                }
+                const auto name = file->GetFilename();
+                h = Fnv1a(name.data(), name.size(), h);
+                h = Fnv1aValue(file->GetCompileIndex(), h);
+                h = Fnv1aValue(file->GetSmallFileCompileIndex(), h);
+            }
+        }
+        return h;
+    }
+
+    bool TryLoad(const fs::path& cachePath, std::uint64_t fingerprint, Config& out)
+    {
+        const MappedFile file(cachePath);
+        if (!file.data()) {
+            return false;
+        }
+
+        Reader header(file.data(), file.size());
+        CacheHeader hdr{};
+        if (!header.Read(hdr) || hdr.magic != kCacheMagic || hdr.version != kCacheVersion) {
+            logger::info("Config cache {} has an unknown layout; rebuilding", cachePath.string());
+            return false;
+        }
+        if (hdr.fingerprint != fingerprint) {
+            logger::info("Config cache is stale (INI or load order changed); rebuilding");
+            return false;
+        }
+
+        const auto* payload = file.data() + sizeof(CacheHeader);
+        if (hdr.payloadSize != file.size() - sizeof(CacheHeader) || Fnv1a(payload, hdr.payloadSize) != hdr.payloadHash) {
+            logger::warn("Config cache {} is corrupt; rebuilding", cachePath.string());
+            return false;
+        }
+
+        Reader r(payload, static_cast<std::size_t>(hdr.payloadSize));
+        CachedScalars s{};
+        std::vector<RE::FormID> allowRaces;
+        std::vector<RE::FormID> denyRaces;
+        std::vector<CachedKeywordMult> keywordMults;
+        std::vector<RE::FormID> allowArchetypes;
+        std::vector<RE::FormID> denyArchetypes;
+
+        if (!r.Read(s) || !r.ReadArray(allowRaces) || !r.ReadArray(denyRaces) || !r.ReadArray(keywordMults) ||
+            !r.ReadArray(allowArchetypes) || !r.ReadArray(denyArchetypes) || !r.AtEnd()) {
+            logger::warn("Config cache {} is truncated; rebuilding", cachePath.string());
+            return false;
+        }
+
+        Config cfg{};
+        cfg.shoveMagnitude = s.shoveMagnitude;
+        cfg.shoveDuration = s.shoveDuration;
+        cfg.applyCurrentMinVelocity = s.applyCurrentMinVelocity;
+        cfg.minDurationScale = s.minDurationScale;
+        cfg.shoveRetries = s.shoveRetries;
+        cfg.shoveRetryDelayFrames = s.shoveRetryDelayFrames;
+        cfg.shoveInitialDelayFrames = s.shoveInitialDelayFrames;
+        cfg.minShoveSeparationDelta = s.minShoveSeparationDelta;
+        cfg.minSeparationDistance = s.minSeparationDistance;
+        cfg.separationPushDuration = s.separationPushDuration;
+        cfg.separationMaxVelocity = s.separationMaxVelocity;
+        cfg.separationRetries = s.separationRetries;
+        cfg.separationInitialDelayFrames = s.separationInitialDelayFrames;
+        cfg.separationRetryDelayFrames = s.separationRetryDelayFrames;
+        cfg.unarmedMultiplier = s.unarmedMultiplier;
+        cfg.powerAttackMultiplier = s.powerAttackMultiplier;
+        cfg.disableInFirstPerson = s.disableInFirstPerson != 0;
+        cfg.enforceMinSeparation = s.enforceMinSeparation != 0;
+        cfg.asyncBinaryTrace = s.asyncBinaryTrace != 0;
+        cfg.captureTrace = s.captureTrace != 0;
+        cfg.statsIntervalSeconds = s.statsIntervalSeconds;
+        cfg.adaptiveRetries = s.adaptiveRetries != 0;
+        cfg.adaptiveMinRetries = s.adaptiveMinRetries;
+        cfg.adaptiveMaxInitialDelayFrames = s.adaptiveMaxInitialDelayFrames;
+        cfg.frameBudgetJobs = s.frameBudgetJobs;
+        cfg.frameBudgetMicros = s.frameBudgetMicros;
+        cfg.frameBudgetDegrade = s.frameBudgetDegrade != 0;
+        cfg.lodMidDistance = s.lodMidDistance;
+        cfg.lodFarDistance = s.lodFarDistance;
+        cfg.lodFarImpulse = s.lodFarImpulse != 0;
+
+        cfg.allowRaces = FlatSet<RE::FormID>(std::move(allowRaces));
+        cfg.denyRaces = FlatSet<RE::FormID>(std::move(denyRaces));
+
+        std::vector<std::pair<RE::BGSKeyword*, float>> mults;
+        mults.reserve(keywordMults.size());
+        for (const auto& e : keywordMults) {
+            auto* kw = RE::TESForm::LookupByID<RE::BGSKeyword>(e.keyword);
+            if (!kw) {
+                logger::warn("Config cache: keyword {:08X} no longer resolves; rebuilding", e.keyword);
+                return false;
+            }
+            mults.emplace_back(kw, e.mult);
+        }
+        cfg.weaponTypeKeywordMultipliers = FlatMap<RE::BGSKeyword*, float>(std::move(mults));
+
+        if (!ResolveKeywords(allowArchetypes, cfg.allowArchetypeKeywords) ||
+            !ResolveKeywords(denyArchetypes, cfg.denyArchetypeKeywords)) {
+            logger::warn("Config cache: archetype keyword no longer resolves; rebuilding");
+            return false;
+        }
+
+        out = std::move(cfg);
+        return true;
+    }
+
+    void Save(const fs::path& cachePath, std::uint64_t fingerprint, const Config& cfg)
+    {
+        CachedScalars s{};
+        s.shoveMagnitude = cfg.shoveMagnitude;
+        s.shoveDuration = cfg.shoveDuration;
+        s.applyCurrentMinVelocity = cfg.applyCurrentMinVelocity;
+        s.minDurationScale = cfg.minDurationScale;
+        s.shoveRetries = cfg.shoveRetries;
+        s.shoveRetryDelayFrames = cfg.shoveRetryDelayFrames;
+        s.shoveInitialDelayFrames = cfg.shoveInitialDelayFrames;
+        s.minShoveSeparationDelta = cfg.minShoveSeparationDelta;
+        s.minSeparationDistance = cfg.minSeparationDistance;
+        s.separationPushDuration = cfg.separationPushDuration;
+        s.separationMaxVelocity = cfg.separationMaxVelocity;
+        s.separationRetries = cfg.separationRetries;
+        s.separationInitialDelayFrames = cfg.separationInitialDelayFrames;
+        s.separationRetryDelayFrames = cfg.separationRetryDelayFrames;
+        s.unarmedMultiplier = cfg.unarmedMultiplier;
+        s.powerAttackMultiplier = cfg.powerAttackMultiplier;
+        s.disableInFirstPerson = cfg.disableInFirstPerson ? 1 : 0;
+        s.enforceMinSeparation = cfg.enforceMinSeparation ? 1 : 0;
+        s.asyncBinaryTrace = cfg.asyncBinaryTrace ? 1 : 0;
+        s.captureTrace = cfg.captureTrace ? 1 : 0;
+        s.statsIntervalSeconds = cfg.statsIntervalSeconds;
+        s.adaptiveRetries = cfg.adaptiveRetries ? 1 : 0;
+        s.adaptiveMinRetries = cfg.adaptiveMinRetries;
+        s.adaptiveMaxInitialDelayFrames = cfg.adaptiveMaxInitialDelayFrames;
+        s.frameBudgetJobs = cfg.frameBudgetJobs;
+        s.frameBudgetMicros = cfg.frameBudgetMicros;
+        s.frameBudgetDegrade = cfg.frameBudgetDegrade ? 1 : 0;
+        s.lodMidDistance = cfg.lodMidDistance;
+        s.lodFarDistance = cfg.lodFarDistance;
+        s.lodFarImpulse = cfg.lodFarImpulse ? 1 : 0;
+
+        std::vector<CachedKeywordMult> keywordMults;
+        keywordMults.reserve(cfg.weaponTypeKeywordMultipliers.size());
+        for (const auto& [kw, mult] : cfg.weaponTypeKeywordMultipliers) {
+            if (kw) {
+                keywordMults.push_back({ kw->GetFormID(), mult });
+            }
+        }
+
+        Writer w;
+        w.Write(CacheHeader{});
+        w.Write(s);
+        w.WriteArray(std::vector<RE::FormID>(cfg.allowRaces.begin(), cfg.allowRaces.end()));
+        w.WriteArray(std::vector<RE::FormID>(cfg.denyRaces.begin(), cfg.denyRaces.end()));
+        w.WriteArray(keywordMults);
+        w.WriteArray(KeywordIDs(cfg.allowArchetypeKeywords));
+        w.WriteArray(KeywordIDs(cfg.denyArchetypeKeywords));
+
+        auto& bytes = w.bytes();
+        CacheHeader hdr{};
+        hdr.fingerprint = fingerprint;
+        hdr.payloadSize = bytes.size() - sizeof(CacheHeader);
+        hdr.payloadHash = Fnv1a(bytes.data() + sizeof(CacheHeader), static_cast<std::size_t>(hdr.payloadSize));
+        std::memcpy(bytes.data(), &hdr, sizeof(hdr));
+
+        std::error_code ec;
+        fs::create_directories(cachePath.parent_path(), ec);
+
+        auto tmpPath = cachePath;
+        tmpPath += ".tmp";
+        {
+            std::ofstream f(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!f.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) {
+                logger::warn("Config cache: failed to write {}", tmpPath.string());
+                return;
+            }
+        }
+
+        fs::rename(tmpPath, cachePath, ec);
+        if (ec) {
+            logger::warn("Config cache: failed to replace {}: {}", cachePath.string(), ec.message());
+            fs::remove(tmpPath, ec);
+            return;
+        }
+        logger::info("Config cache written: {} ({} bytes)", cachePath.string(), bytes.size());
+    }
+}
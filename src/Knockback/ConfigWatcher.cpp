@@ -0,0 +1,236 @@
+#include <Knockback/ConfigWatcher.h>
+
+#include <algorithm>
+#include <stop_token>
+#include <system_error>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#elif defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace Knockback
+{
+    namespace
+    {
+        using namespace std::chrono_literals;
+
+        // Wakes the watcher when something in the watched directories changes. The watcher
+        // always re-stats the files afterwards, so spurious wakeups are harmless.
+        class ChangeNotifier
+        {
+        public:
+            ChangeNotifier(const std::vector<fs::path>& dirs, bool enabled)
+            {
+                if (!enabled) {
+                    return;
+                }
+
+#if defined(_WIN32)
+                _stopEvent = ::CreateEventW(nullptr, TRUE, FALSE, nullptr);
+                for (const auto& dir : dirs) {
+                    const auto h = ::FindFirstChangeNotificationW(
+                        dir.c_str(), FALSE, FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE);
+                    if (h != INVALID_HANDLE_VALUE) {
+                        _handles.push_back(h);
+                    }
+                }
+#elif defined(__linux__)
+                _fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+                if (_fd >= 0) {
+                    for (const auto& dir : dirs) {
+                        ::inotify_add_watch(_fd, dir.c_str(), IN_CLOSE_WRITE | IN_MODIFY | IN_CREATE | IN_DELETE | IN_MOVED_TO | IN_MOVED_FROM);
+                    }
+                }
+#else
+                (void)dirs;
+#endif
+            }
+
+            ~ChangeNotifier()
+            {
+#if defined(_WIN32)
+                for (const auto h : _handles) {
+                    ::FindCloseChangeNotification(h);
+                }
+                if (_stopEvent) {
+                    ::CloseHandle(_stopEvent);
+                }
+#elif defined(__linux__)
+                if (_fd >= 0) {
+                    ::close(_fd);
+                }
+#endif
+            }
+
+            ChangeNotifier(const ChangeNotifier&) = delete;
+            ChangeNotifier& operator=(const ChangeNotifier&) = delete;
+
+            // Returns after a change notification, the timeout, or a stop request.
+            void Wait(std::chrono::milliseconds timeout, std::stop_token stop)
+            {
+#if defined(_WIN32)
+                if (!_handles.empty() && _stopEvent) {
+                    std::stop_callback onStop(stop, [this]() { ::SetEvent(_stopEvent); });
+
+                    std::vector<HANDLE> waitSet(_handles);
+                    waitSet.push_back(_stopEvent);
+
+                    const auto r = ::WaitForMultipleObjects(
+                        static_cast<DWORD>(waitSet.size()), waitSet.data(), FALSE, static_cast<DWORD>(timeout.count()));
+                    if (r >= WAIT_OBJECT_0 && r < WAIT_OBJECT_0 + _handles.size()) {
+                        ::FindNextChangeNotification(_handles[r - WAIT_OBJECT_0]);
+                    }
+                    return;
+                }
+#elif defined(__linux__)
+                if (_fd >= 0) {
+                    // Short slices so a stop request is noticed promptly.
+                    const auto deadline = std::chrono::steady_clock::now() + timeout;
+                    while (!stop.stop_requested()) {
+                        const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+                        if (left <= 0ms) {
+                            return;
+                        }
+
+                        pollfd pfd{ _fd, POLLIN, 0 };
+                        if (::poll(&pfd, 1, static_cast<int>(std::min(left, 100ms).count())) > 0) {
+                            char buf[4096];
+                            while (::read(_fd, buf, sizeof(buf)) > 0) {
+                            }
+                            return;
+                        }
+                    }
+                    return;
+                }
+#endif
+                const auto deadline = std::chrono::steady_clock::now() + timeout;
+                while (!stop.stop_requested() && std::chrono::steady_clock::now() < deadline) {
+                    std::this_thread::sleep_for(std::min<std::chrono::milliseconds>(timeout, 50ms));
+                }
+            }
+
+        private:
+#if defined(_WIN32)
+            std::vector<HANDLE> _handles;
+            HANDLE _stopEvent{ nullptr };
+#elif defined(__linux__)
+            int _fd{ -1 };
+#endif
+        };
+    }
+
+    ConfigWatcher::ConfigWatcher(std::vector<fs::path> files, ChangeCallback onChange, Options opts) :
+        _files(std::move(files)),
+        _onChange(std::move(onChange)),
+        _opts(opts)
+    {}
+
+    ConfigWatcher::~ConfigWatcher()
+    {
+        Stop();
+    }
+
+    void ConfigWatcher::Start()
+    {
+        if (_thread.joinable()) {
+            return;
+        }
+        _thread = std::jthread([this](std::stop_token stop) { Run(stop); });
+    }
+
+    void ConfigWatcher::Stop()
+    {
+        if (!_thread.joinable()) {
+            return;
+        }
+        _thread.request_stop();
+        _thread.join();
+    }
+
+    std::vector<ConfigWatcher::FileState> ConfigWatcher::Snapshot() const
+    {
+        std::vector<FileState> out(_files.size());
+
+        for (std::size_t i = 0; i < _files.size(); ++i) {
+            std::error_code ec;
+            if (!fs::exists(_files[i], ec) || ec) {
+                continue;
+            }
+
+            auto& st = out[i];
+            st.writeTime = fs::last_write_time(_files[i], ec);
+            if (ec) {
+                continue;
+            }
+            st.size = fs::file_size(_files[i], ec);
+            st.exists = !ec;
+        }
+        return out;
+    }
+
+    std::uint32_t ConfigWatcher::Diff(const std::vector<FileState>& a, const std::vector<FileState>& b) const
+    {
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < a.size() && i < b.size() && i < 32; ++i) {
+            if (!(a[i] == b[i])) {
+                mask |= 1u << i;
+            }
+        }
+        return mask;
+    }
+
+    void ConfigWatcher::Run(std::stop_token stop)
+    {
+        std::vector<fs::path> dirs;
+        for (const auto& f : _files) {
+            auto dir = f.parent_path();
+            if (dir.empty()) {
+                dir = ".";
+            }
+            std::error_code ec;
+            if (fs::is_directory(dir, ec) && std::find(dirs.begin(), dirs.end(), dir) == dirs.end()) {
+                dirs.push_back(std::move(dir));
+            }
+        }
+
+        ChangeNotifier notifier(dirs, _opts.useNotifications);
+
+        auto reported = Snapshot();
+        auto seen = reported;
+        auto lastChange = std::chrono::steady_clock::now();
+        bool pending = false;
+
+        while (!stop.stop_requested()) {
+            notifier.Wait(pending ? _opts.debounce : _opts.pollInterval, stop);
+            if (stop.stop_requested()) {
+                break;
+            }
+
+            auto now = Snapshot();
+            if (now != seen) {
+                // Still being written (editors often save in several steps): restart the debounce.
+                seen = std::move(now);
+                lastChange = std::chrono::steady_clock::now();
+                pending = true;
+                continue;
+            }
+
+            if (!pending || std::chrono::steady_clock::now() - lastChange < _opts.debounce) {
+                continue;
+            }
+
+            pending = false;
+            const auto mask = Diff(reported, seen);
+            reported = seen;
+            if (mask != 0 && _onChange) {
+                _onChange(mask);
+            }
+        }
+    }
+}
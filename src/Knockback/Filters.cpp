@@ -2,56 +2,112 @@
 #include <Knockback/Config.h>
 
 #include <RE/P/PlayerCharacter.h>
+#include <RE/T/TESDataHandler.h>
 #include <RE/T/TESRace.h>
-#include <Knockback/Log.h>
+#include <Knockback/BinLog.h>
+#include <Knockback/Metrics.h>
+
+#include <algorithm>
+#include <unordered_map>
 
-namespace logger = SKSE::log;
 namespace Knockback
 {
-    // Keyword helpers (fallback heuristic)
-    constexpr RE::FormID kKW_ActorTypeNPC = 0x00013794;               // ActorTypeNPC
-    constexpr RE::FormID kKW_ActorTypeUndead = 0x00013796;            // ActorTypeUndead
-    constexpr RE::FormID kKW_ActorTypeDragon = 0x00035D59;            // ActorTypeDragon
-    constexpr RE::FormID kKW_ActorTypeGiant = 0x0010E984;             // ActorTypeGiant
-
-    struct KeywordCache {
-        RE::BGSKeyword* npc{ nullptr };
-        RE::BGSKeyword* undead{ nullptr };
-        RE::BGSKeyword* falmer{ nullptr };
-        RE::BGSKeyword* dragon{ nullptr };
-        RE::BGSKeyword* giant{ nullptr };
-
-        void Init()
-        {
-            npc = RE::TESForm::LookupByID<RE::BGSKeyword>(kKW_ActorTypeNPC);
-            undead = RE::TESForm::LookupByID<RE::BGSKeyword>(kKW_ActorTypeUndead);
-            dragon = RE::TESForm::LookupByID<RE::BGSKeyword>(kKW_ActorTypeDragon);
-            giant = RE::TESForm::LookupByID<RE::BGSKeyword>(kKW_ActorTypeGiant);
-        }
+    // Per-base archetype flags for actors whose own record carries keywords. Rebuilt lazily
+    // whenever a new config epoch shows up. Main thread only, like every target check.
+    struct ActorArchetypeCache
+    {
+        std::uint64_t epoch{ 0 };
+        std::unordered_map<RE::FormID, std::uint8_t> flags;
     };
 
-    static KeywordCache g_kw;
+    static ActorArchetypeCache g_actorArchetypes;
 
-    void InitKeywords()
+    // Multiplier per weapon form. A weapon's keywords never change, so the scan over
+    // weaponTypeKeywordMultipliers only needs to happen once per config epoch. Main thread
+    // only, like every target check.
+    struct WeaponMultiplierCache
     {
-        g_kw.Init();
+        std::uint64_t epoch{ 0 };
+        std::unordered_map<RE::FormID, float> mults;
+    };
+
+    static WeaponMultiplierCache g_weaponMults;
+
+    template <class HasKeywordFn>
+    static std::uint8_t ArchetypeFlags(const Config& cfg, HasKeywordFn&& hasKeyword)
+    {
+        std::uint8_t flags = 0;
+
+        for (const auto* kw : cfg.denyArchetypeKeywords) {
+            if (kw && hasKeyword(kw)) {
+                flags |= kTargetKeywordDenied;
+                break;
+            }
+        }
+        for (const auto* kw : cfg.allowArchetypeKeywords) {
+            if (kw && hasKeyword(kw)) {
+                flags |= kTargetKeywordAllowed;
+                break;
+            }
+        }
+        return flags;
     }
 
-    static bool HasKW(const RE::Actor* actor, const RE::BGSKeyword* kw)
+    static std::uint8_t RaceFlags(const Config& cfg, const RE::TESRace* race)
     {
-        if (!actor || !kw) {
-            return false;
+        const auto raceID = race->GetFormID();
+
+        // deny list wins; an explicit allow list can add races (wolves, spiders, etc.)
+        if (cfg.denyRaces.contains(raceID)) {
+            return kTargetListDenied;
+        }
+        if (cfg.HasAllowList() && cfg.allowRaces.contains(raceID)) {
+            return kTargetListAllowed;
         }
 
-        if (actor->HasKeyword(kw)) {
-            return true;
+        return ArchetypeFlags(cfg, [&](const RE::BGSKeyword* kw) { return race->HasKeyword(kw); });
+    }
+
+    static std::uint8_t ActorOwnArchetypeFlags(const Config& cfg, const RE::Actor* actor)
+    {
+        // Most bases carry no keywords of their own; their race already decided.
+        const auto* base = actor->GetActorBase();
+        if (!base || base->GetNumKeywords() == 0) {
+            return 0;
         }
 
-        if (auto race = actor->GetRace(); race && race->HasKeyword(kw)) {
-            return true;
+        if (g_actorArchetypes.epoch != cfg.epoch) {
+            g_actorArchetypes.flags.clear();
+            g_actorArchetypes.epoch = cfg.epoch;
         }
 
-        return false;
+        const auto [it, inserted] = g_actorArchetypes.flags.try_emplace(base->GetFormID(), std::uint8_t{ 0 });
+        if (inserted) {
+            it->second = ArchetypeFlags(cfg, [&](const RE::BGSKeyword* kw) { return actor->HasKeyword(kw); });
+        }
+        return it->second;
+    }
+
+    void BuildTargetTables(Config& cfg)
+    {
+        cfg.raceTargetFlags = {};
+
+        auto* data = RE::TESDataHandler::GetSingleton();
+        if (!data) {
+            return;
+        }
+
+        const auto& races = data->GetFormArray<RE::TESRace>();
+
+        std::vector<std::pair<RE::FormID, std::uint8_t>> entries;
+        entries.reserve(races.size());
+        for (const auto* race : races) {
+            if (race) {
+                entries.emplace_back(race->GetFormID(), RaceFlags(cfg, race));
+            }
+        }
+
+        cfg.raceTargetFlags = FlatMap<RE::FormID, std::uint8_t>(std::move(entries));
     }
 
     bool IsPlayer(RE::Actor* a)
@@ -60,10 +116,8 @@ namespace Knockback
         return a && player && a == player;
     }
 
-    bool ShouldDisableDueToFirstPerson(RE::Actor* aggressor)
+    bool ShouldDisableDueToFirstPerson(const Config& cfg, RE::Actor* aggressor)
     {
-        const auto& cfg = GetConfig();
-
         if (!cfg.disableInFirstPerson) {
             return false;
         }
@@ -110,56 +164,59 @@ namespace Knockback
         return 0;
     }
 
-    bool IsValidKnockbackTarget(const RE::Actor* target)
+    bool IsValidKnockbackTarget(const Config& cfg, const RE::Actor* target)
     {
-        const auto& cfg = GetConfig();
-
         if (!target) {
             return false;
         }
 
-        const auto raceID = ResolveActorRaceID(target);
-        if (!raceID) {
-            logger::trace("Race gate: no race resolved for target {:08X}", target ? target->GetFormID() : 0);
+        const auto* race = ResolveActorRace(target);
+        if (!race) {
+            KB_TRACE("Race gate: no race resolved for target {:08X}", target->GetFormID());
             return false;
         }
 
-        // deny list wins
-        if (cfg.denyRaces.contains(raceID)) {
-            logger::trace("Race denied for target {:08X} with race {:08X}", target ? target->GetFormID() : 0, raceID);
+        const auto raceID = race->GetFormID();
+
+        std::uint8_t flags = 0;
+        if (const auto* precomputed = cfg.raceTargetFlags.find(raceID)) {
+            flags = *precomputed;
+        }
+        else {
+            // Race created after the table was built; evaluate it directly.
+            flags = RaceFlags(cfg, race);
+        }
+
+        if (flags & kTargetListDenied) {
+            KB_TRACE("Race denied for target {:08X} with race {:08X}", target->GetFormID(), raceID);
             return false;
         }
 
-        // allow list enforced if present
-        // Explicit allow list can add races (wolves, spiders, etc.)
-        if (cfg.HasAllowList() && cfg.allowRaces.contains(raceID)) {
-            logger::trace("Race allowed for target {:08X} with race {:08X}", target ? target->GetFormID() : 0, raceID);
+        if (flags & kTargetListAllowed) {
+            KB_TRACE("Race allowed for target {:08X} with race {:08X}", target->GetFormID(), raceID);
             return true;
         }
 
+        // Not listed: the actor's own archetype keywords count alongside the race's.
+        flags |= ActorOwnArchetypeFlags(cfg, target);
+
         // exclude big archetypes
-        if (HasKW(target, g_kw.dragon) || HasKW(target, g_kw.giant)) {
-			logger::trace("Target with prohibited archetype (dragon/giant) {:08X}", target->GetFormID());
+        if (flags & kTargetKeywordDenied) {
+            KB_TRACE("Target with prohibited archetype {:08X}", target->GetFormID());
             return false;
         }
 
         // allow humanoids + undead humanoids
-        if (HasKW(target, g_kw.npc) || HasKW(target, g_kw.undead)) {
-			logger::trace("Target with allowed archetype (NPC/Undead) {:08X}", target->GetFormID());
+        if (flags & kTargetKeywordAllowed) {
+            KB_TRACE("Target with allowed archetype {:08X}", target->GetFormID());
             return true;
         }
 
         return false;
     }
 
-    float GetWeaponMultiplier(const RE::TESObjectWEAP* weap)
+    static float ComputeWeaponMultiplier(const Config& cfg, const RE::TESObjectWEAP* weap)
     {
-        const auto& cfg = Knockback::GetConfig();
-
-        if (!weap || weap->GetWeaponType() == RE::WEAPON_TYPE::kHandToHandMelee) {
-            return cfg.unarmedMultiplier;
-        }
-
         float best = 0.0f;
         for (const auto& [kw, mult] : cfg.weaponTypeKeywordMultipliers) {
             if (kw && weap->HasKeyword(kw)) {
@@ -169,14 +226,42 @@ namespace Knockback
         return best;
     }
 
+    float GetWeaponMultiplier(const Config& cfg, const RE::TESObjectWEAP* weap)
+    {
+        if (!weap || weap->GetWeaponType() == RE::WEAPON_TYPE::kHandToHandMelee) {
+            return cfg.unarmedMultiplier;
+        }
+
+        const auto weapID = weap->GetFormID();
+
+        if (g_weaponMults.epoch != cfg.epoch) {
+            if (g_weaponMults.epoch != 0) {
+                KB_TRACE("WeaponCache: epoch {} retired entries={}", g_weaponMults.epoch, g_weaponMults.mults.size());
+            }
+            g_weaponMults.mults.clear();
+            g_weaponMults.epoch = cfg.epoch;
+        }
+
+        const auto [it, inserted] = g_weaponMults.mults.try_emplace(weapID, 0.0f);
+        if (inserted) {
+            Metrics::Add(Metrics::Counter::kWeaponCacheMiss);
+            it->second = ComputeWeaponMultiplier(cfg, weap);
+        }
+        else {
+            Metrics::Add(Metrics::Counter::kWeaponCacheHit);
+        }
+        return it->second;
+    }
+
     bool IsMeleeWeapon(const RE::TESObjectWEAP* weap)
     {
         // "melee" means: it matches any configured keyword, or unarmed is enabled.
+        const auto cfg = AcquireConfig();
         if (!weap || weap->GetWeaponType() == RE::WEAPON_TYPE::kHandToHandMelee) {
-            return Knockback::GetConfig().unarmedMultiplier > 0.0f;
+            return cfg->unarmedMultiplier > 0.0f;
         }
 
-        return GetWeaponMultiplier(weap) != 0.0f;
+        return GetWeaponMultiplier(*cfg, weap) != 0.0f;
     }
 
     bool IsMagicSource(RE::FormID sourceID)
@@ -193,18 +278,6 @@ namespace Knockback
         return form->As<RE::MagicItem>() != nullptr;
     }
 
-    const RE::TESObjectWEAP* ResolveWeaponFromEventOrEquipped(const RE::TESHitEvent& evt, RE::Actor* /*aggressor*/)
-    {
-        if (evt.source != 0) {
-            if (auto* form = RE::TESForm::LookupByID(evt.source)) {
-                if (auto* weap = form->As<RE::TESObjectWEAP>()) {
-                    return weap;
-                }
-            }
-        }
-        return nullptr;
-    }
-
     bool GetIsAttacking(RE::Actor* a)
     {
         bool v = false;
@@ -0,0 +1,179 @@
+#include <Knockback/FormSpecs.h>
+
+#include <Knockback/Ini.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace Knockback::FormSpecs
+{
+    // Plugins named in the report before it switches to a count.
+    constexpr std::size_t kReportPlugins = 8;
+
+    static std::string_view NormalizeHexToken(std::string_view hex)
+    {
+        hex = Ini::Trim(hex);
+
+        if (hex.starts_with("FormID:")) {
+            hex = Ini::Trim(hex.substr(7));
+        }
+        if (hex.starts_with("0x") || hex.starts_with("0X")) {
+            hex = Ini::Trim(hex.substr(2));
+        }
+        return hex;
+    }
+
+    std::size_t Batch::NameHash::operator()(std::string_view s) const
+    {
+        // FNV-1a over the lower-cased name: plugin file names are case-insensitive.
+        std::size_t h = 2166136261u;
+        for (char c : s) {
+            const char lower = (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+            h = (h ^ static_cast<unsigned char>(lower)) * 16777619u;
+        }
+        return h;
+    }
+
+    bool Batch::NameEquals::operator()(std::string_view a, std::string_view b) const
+    {
+        return Ini::IEquals(a, b);
+    }
+
+    Batch::Batch(std::pmr::memory_resource* arena) :
+        _arena(arena),
+        _entries(arena),
+        _plugins(arena),
+        _pluginIndex(arena),
+        _specs(arena)
+    {}
+
+    std::string_view Batch::Intern(std::string_view s)
+    {
+        if (s.empty()) {
+            return {};
+        }
+        auto* copy = static_cast<char*>(_arena->allocate(s.size(), alignof(char)));
+        std::memcpy(copy, s.data(), s.size());
+        return { copy, s.size() };
+    }
+
+    Batch::Handle Batch::Add(std::string_view spec)
+    {
+        // Names and specs below are views of this copy, not of the caller's text.
+        const auto cleaned = Intern(Ini::StripComment(spec));
+        const auto bar = cleaned.find('|');
+        const auto file = bar == std::string_view::npos ? std::string_view{} : Ini::Trim(cleaned.substr(0, bar));
+        const auto hex = bar == std::string_view::npos ? std::string_view{} : NormalizeHexToken(cleaned.substr(bar + 1));
+
+        std::uint32_t localID = 0;
+        if (file.empty() || hex.empty() || !Ini::ParseHexPrefix(hex, localID)) {
+            if (_malformed++ == 0) {
+                _firstMalformed = cleaned;
+            }
+            return kInvalid;
+        }
+
+        // Lists tend to name one plugin many lines in a row; skip the hash for those.
+        if (_plugins.empty() || !Ini::IEquals(_plugins[_lastPlugin].name, file)) {
+            const auto [it, inserted] = _pluginIndex.try_emplace(file, static_cast<std::uint32_t>(_plugins.size()));
+            if (inserted) {
+                _plugins.emplace_back().name = file;
+            }
+            _lastPlugin = it->second;
+        }
+        ++_plugins[_lastPlugin].entries;
+
+        _entries.push_back(Entry{ _lastPlugin, localID, 0 });
+        _specs.push_back(cleaned);
+        return static_cast<Handle>(_entries.size() - 1);
+    }
+
+    void Batch::Resolve(const IPluginTable& plugins)
+    {
+        for (auto& plugin : _plugins) {
+            plugin.slot = plugins.Find(plugin.name);
+        }
+        for (auto& entry : _entries) {
+            const auto& slot = _plugins[entry.plugin].slot;
+            entry.formID = slot ? ToFormID(*slot, entry.localID) : 0;
+        }
+    }
+
+    std::uint32_t Batch::FormID(Handle h) const
+    {
+        return h < _entries.size() ? _entries[h].formID : 0;
+    }
+
+    void Batch::Reject(Handle h)
+    {
+        if (h >= _entries.size()) {
+            return;
+        }
+        auto& plugin = _plugins[_entries[h].plugin];
+        if (plugin.rejected++ == 0) {
+            plugin.firstRejected = _specs[h];
+        }
+    }
+
+    std::size_t Batch::UnresolvedCount() const
+    {
+        std::size_t count = _malformed;
+        for (const auto& plugin : _plugins) {
+            count += plugin.slot ? plugin.rejected : plugin.entries;
+        }
+        return count;
+    }
+
+    std::string Batch::Report() const
+    {
+        const auto unresolved = UnresolvedCount();
+        if (unresolved == 0) {
+            return {};
+        }
+
+        std::string out;
+        char buf[256];
+        auto append = [&](int n) {
+            if (n > 0) out.append(buf, std::min<std::size_t>(static_cast<std::size_t>(n), sizeof(buf) - 1));
+        };
+
+        append(std::snprintf(buf, sizeof(buf), "%zu of %zu FormSpecs unresolved (%zu plugins looked up):",
+            unresolved, _entries.size() + _malformed, _plugins.size()));
+        if (_malformed) {
+            append(std::snprintf(buf, sizeof(buf), " %u malformed (first '%.*s');", _malformed,
+                static_cast<int>(_firstMalformed.size()), _firstMalformed.data()));
+        }
+
+        std::size_t named = 0;
+        std::size_t unnamed = 0;
+        for (const auto& plugin : _plugins) {
+            const bool missing = !plugin.slot;
+            if (!missing && plugin.rejected == 0) {
+                continue;
+            }
+            if (named == kReportPlugins) {
+                ++unnamed;
+                continue;
+            }
+            ++named;
+            const int nameLen = static_cast<int>(plugin.name.size());
+            if (missing) {
+                append(std::snprintf(buf, sizeof(buf), " %.*s not loaded (%u);", nameLen, plugin.name.data(), plugin.entries));
+            }
+            else {
+                append(std::snprintf(buf, sizeof(buf), " %.*s: %u not found or wrong type (first '%.*s');", nameLen,
+                    plugin.name.data(), plugin.rejected, static_cast<int>(plugin.firstRejected.size()),
+                    plugin.firstRejected.data()));
+            }
+        }
+        if (unnamed) {
+            append(std::snprintf(buf, sizeof(buf), " %zu more plugins;", unnamed));
+        }
+
+        if (out.back() == ';') {
+            out.pop_back();
+        }
+        return out;
+    }
+}
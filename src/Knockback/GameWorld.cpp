@@ -0,0 +1,209 @@
+#include <Knockback/GameWorld.h>
+
+#include <Knockback/BinLog.h>
+#include <Knockback/Config.h>
+#include <Knockback/Filters.h>
+#include <Knockback/Metrics.h>
+
+#include "SKSE/SKSE.h"
+#include <xmmintrin.h>
+#include <utility>
+
+namespace logger = SKSE::log;
+
+namespace Knockback
+{
+    // Events queued between two drains. Past this the rest are dropped; the tracker re-reads
+    // an actor's attack state once it has been quiet for a while (AttackTracker.cpp).
+    constexpr std::size_t kMaxPendingAttackEvents = 1024;
+
+    static RE::NiPointer<RE::Actor> ResolveActor(ActorId id)
+    {
+        if (id == 0) {
+            return {};
+        }
+
+        RE::NiPointer<RE::TESObjectREFR> ref;
+        const RE::RefHandle handle = id;
+        if (!RE::LookupReferenceByHandle(handle, ref) || !ref) {
+            return {};
+        }
+        return RE::NiPointer<RE::Actor>(ref->As<RE::Actor>());
+    }
+
+    // Every Settings the core hands back to us in-game is the base of a published Config
+    // (AcquireSettings below is the only source), so the filter tables are right behind it.
+    static const Config& AsConfig(const Settings& settings)
+    {
+        return static_cast<const Config&>(settings);
+    }
+
+    GameWorld& GameWorld::GetSingleton()
+    {
+        static GameWorld world;
+        return world;
+    }
+
+    ActorId GameWorld::ToId(RE::Actor* actor)
+    {
+        return actor ? actor->GetHandle().native_handle() : 0;
+    }
+
+    SettingsPtr GameWorld::AcquireSettings()
+    {
+        return AcquireConfig();
+    }
+
+    bool GameWorld::GetActorState(ActorId id, ActorState& out) const
+    {
+        const auto actor = ResolveActor(id);
+        if (!actor) {
+            return false;
+        }
+
+        const auto pos = actor->GetPosition();
+        out.position = Vec3{ pos.x, pos.y, pos.z };
+        out.dead = actor->IsDead();
+        out.player = IsPlayer(actor.get());
+        const auto* race = actor->GetRace();
+        out.race = race ? race->GetFormID() : 0;
+        return true;
+    }
+
+    bool GameWorld::IsAttacking(ActorId id) const
+    {
+        const auto actor = ResolveActor(id);
+        return actor && GetIsAttacking(actor.get());
+    }
+
+    bool GameWorld::IsValidTarget(const Settings& settings, ActorId target) const
+    {
+        const auto actor = ResolveActor(target);
+        return actor && IsValidKnockbackTarget(AsConfig(settings), actor.get());
+    }
+
+    bool GameWorld::SuppressedByFirstPerson(const Settings& settings, ActorId aggressor) const
+    {
+        const auto actor = ResolveActor(aggressor);
+        return actor && ShouldDisableDueToFirstPerson(AsConfig(settings), actor.get());
+    }
+
+    bool GameWorld::GetCameraPosition(Vec3& out) const
+    {
+        auto* camera = RE::PlayerCamera::GetSingleton();
+        if (!camera || !camera->cameraRoot) {
+            return false;
+        }
+
+        const auto& pos = camera->cameraRoot->world.translate;
+        out = Vec3{ pos.x, pos.y, pos.z };
+        return true;
+    }
+
+    bool GameWorld::ApplyCurrent(ActorId targetId, const Vec3& velocity, float duration)
+    {
+        const auto target = ResolveActor(targetId);
+        if (!target) {
+            KB_TRACE("ApplyPhysicsShove: target no longer resolves {:08X}", targetId);
+            return false;
+        }
+
+        // Physics/3D validity gates (avoid ApplyCurrent crash paths)
+        if (!target->Is3DLoaded()) {
+            KB_TRACE("ApplyPhysicsShove: target not 3D loaded {:08X}", target->GetFormID());
+            return false;
+        }
+
+        auto* node = target->Get3D();
+        if (!node) {
+            KB_TRACE("ApplyPhysicsShove: target has no 3D {:08X}", target->GetFormID());
+            return false;
+        }
+
+        // controller gate. 
+        auto* cc = target->GetCharController();
+        if (!cc) {
+            KB_TRACE("ApplyPhysicsShove: no char controller {:08X}", target->GetFormID());
+            return false;
+        }
+
+        RE::hkVector4 vel{};
+        vel.quad = _mm_setr_ps(velocity.x, velocity.y, velocity.z, 0.0f);
+
+        KB_TRACE("ApplyPhysicsShove: applying vel=({}, {}, {}) dur={} to target {:08X}",
+            vel.quad.m128_f32[0],
+            vel.quad.m128_f32[1],
+            vel.quad.m128_f32[2],
+            duration,
+            target->GetFormID());
+        return target->ApplyCurrent(duration, vel);
+    }
+
+    // Attack tags of the vanilla behaviour graphs. weaponSwing fires on every swing of a
+    // combo, so it also restarts an attack whose attackStart was missed; a stagger or recoil
+    // cuts an attack short without an attackStop.
+    static bool ClassifyAttackTag(const RE::BSFixedString& tag, AttackEventKind& out)
+    {
+        if (tag == "attackStart" || tag == "weaponSwing" || tag == "weaponLeftSwing") {
+            out = AttackEventKind::kStart;
+            return true;
+        }
+        if (tag == "attackStop" || tag == "staggerStart" || tag == "recoilStart" || tag == "recoilLargeStart") {
+            out = AttackEventKind::kEnd;
+            return true;
+        }
+        return false;
+    }
+
+    bool GameWorld::Watch(ActorId id)
+    {
+        const auto actor = ResolveActor(id);
+        // The graph ignores a sink it already has, so watching again is harmless.
+        return actor && actor->AddAnimationGraphEventSink(this);
+    }
+
+    void GameWorld::Drain(std::vector<AttackEvent>& out)
+    {
+        std::scoped_lock lock(_eventsMutex);
+        out.insert(out.end(), _events.begin(), _events.end());
+        _events.clear();
+
+        // A lost attack end leaves its deferrals waiting out their deadline.
+        if (_eventsDropped != _reportedEventDrops) {
+            logger::warn("Attack event queue full: {} events dropped so far (capacity {})", _eventsDropped, kMaxPendingAttackEvents);
+            _reportedEventDrops = _eventsDropped;
+        }
+    }
+
+    RE::BSEventNotifyControl GameWorld::ProcessEvent(
+        const RE::BSAnimationGraphEvent* event,
+        RE::BSTEventSource<RE::BSAnimationGraphEvent>*)
+    {
+        AttackEventKind kind{};
+        if (!event || !event->holder || !ClassifyAttackTag(event->tag, kind)) {
+            return RE::BSEventNotifyControl::kContinue;
+        }
+
+        const auto id = const_cast<RE::TESObjectREFR*>(event->holder)->GetHandle().native_handle();
+
+        std::scoped_lock lock(_eventsMutex);
+        if (_events.size() < kMaxPendingAttackEvents) {
+            _events.push_back(AttackEvent{ id, kind });
+        }
+        else {
+            ++_eventsDropped;
+            Metrics::Add(Metrics::Counter::kAttackEventsDropped);
+        }
+        return RE::BSEventNotifyControl::kContinue;
+    }
+
+    bool GameWorld::AddTask(std::function<void()> fn)
+    {
+        auto taskIf = SKSE::GetTaskInterface();
+        if (!taskIf) {
+            return false;
+        }
+        taskIf->AddTask(std::move(fn));
+        return true;
+    }
+}
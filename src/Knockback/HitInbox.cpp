@@ -0,0 +1,146 @@
+#include <Knockback/HitInbox.h>
+
+#include <Knockback/BinLog.h>
+#include <Knockback/Capture.h>
+#include <Knockback/Config.h>
+#include <Knockback/Filters.h>
+#include <Knockback/GameWorld.h>
+#include <Knockback/Metrics.h>
+#include <Knockback/Ring.h>
+#include <Knockback/Tasks.h>
+
+#include "SKSE/SKSE.h"
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace logger = SKSE::log;
+
+namespace Knockback
+{
+    // A frame rarely sees more than a few dozen hits; this is the backpressure point.
+    constexpr std::size_t kInboxCapacity = 1024;
+
+    static MpscRing<RawHit, kInboxCapacity> g_inbox{};
+    static std::atomic_bool g_drainQueued{ false };
+
+    // Also counted in Metrics; kept here so the drain can warn without collecting them.
+    static std::atomic<std::uint64_t> g_dropped{ 0 };
+
+    // Drain side, main thread only.
+    static std::vector<HitEvent> g_batch{};
+    static std::uint64_t g_reportedDrops{ 0 };
+
+    // What a hit's source form means for the shove. A sweep posts one hit per victim with the
+    // same source and flags, back to back, so the drain resolves it once per run.
+    struct SourceVerdict
+    {
+        RE::FormID source{ 0 };
+        std::uint8_t flags{ 0 };
+        bool valid{ false };
+        bool magic{ false };
+        float weaponMult{ 0.0f };
+    };
+
+    static SourceVerdict ClassifySource(const Config& cfg, RE::FormID source, std::uint8_t flags)
+    {
+        SourceVerdict v{ source, flags, true };
+
+        // One form lookup answers both "is it magic" and "which weapon".
+        const auto* form = source != 0 ? RE::TESForm::LookupByID(source) : nullptr;
+        if (form && form->As<RE::MagicItem>()) {
+            v.magic = true;
+            return v;
+        }
+
+        const auto* weap = form ? form->As<RE::TESObjectWEAP>() : nullptr;
+        v.weaponMult = GetWeaponMultiplier(cfg, weap);
+        if (flags & kRawHitPowerAttack) {
+            v.weaponMult *= cfg.powerAttackMultiplier;
+        }
+        return v;
+    }
+
+    static void EnsureDrainQueued()
+    {
+        if (g_drainQueued.exchange(true, std::memory_order_acq_rel)) {
+            return;
+        }
+        // Straight to the game's queue: the drain is game-side, not a core task (see Capture.h).
+        if (!GameWorld::GetSingleton().AddTask([]() { DrainHitInbox(); })) {
+            g_drainQueued.store(false, std::memory_order_release);
+        }
+    }
+
+    bool PostHit(const RawHit& hit)
+    {
+        const bool queued = g_inbox.TryPush(hit);
+        if (queued) {
+            Metrics::Add(Metrics::Counter::kHitPosted);
+        }
+        else {
+            Metrics::Add(Metrics::Counter::kHitDropped);
+            g_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Armed even when full, so the drain gets a chance to catch up.
+        EnsureDrainQueued();
+        return queued;
+    }
+
+    void DrainHitInbox()
+    {
+        // Clear first so hits posted while we drain arm the next pass.
+        g_drainQueued.store(false, std::memory_order_release);
+
+        const auto start = Metrics::NowMicros();
+        // One pinned snapshot for the drain: the sources are classified and the hits gated
+        // under the same config, even if a reload is published meanwhile.
+        const auto snapshot = AcquireConfig();
+        const auto& cfg = *snapshot;
+        g_batch.clear();
+
+        RawHit raw{};
+        std::size_t popped = 0;
+        SourceVerdict verdict{};
+
+        // Bounded, so producers that never pause cannot pin the main thread here.
+        while (popped < kInboxCapacity && g_inbox.TryPop(raw)) {
+            ++popped;
+            Metrics::Record(Metrics::Histogram::kInboxMicros, start - std::min(start, raw.postedMicros));
+            Capture::RecordRawHit(raw.target, raw.aggressor, raw.source, raw.projectile, raw.flags, raw.frame);
+
+            if (raw.projectile != 0) {
+                Metrics::Add(Metrics::Counter::kHitProjectile);
+                KB_TRACE("Shove: skipped (projectile hit) projectile={:08X}", raw.projectile);
+                continue;
+            }
+
+            if (!verdict.valid || verdict.source != raw.source || verdict.flags != raw.flags) {
+                verdict = ClassifySource(cfg, raw.source, raw.flags);
+            }
+            if (verdict.magic) {
+                Metrics::Add(Metrics::Counter::kHitMagic);
+                KB_TRACE("Shove: skipped (magic source) source={:08X}", raw.source);
+                continue;
+            }
+
+            // Actor gates (dead, first-person, target filter) run in the shared core path,
+            // once per attack for the aggressor side.
+            g_batch.push_back(HitEvent{ raw.aggressor, raw.target, verdict.weaponMult, raw.postedMicros });
+        }
+
+        if (popped == kInboxCapacity) {
+            EnsureDrainQueued();
+        }
+
+        Capture::RecordHits(g_batch, cfg);
+        SubmitHits(snapshot, g_batch);
+        Metrics::Record(Metrics::Histogram::kDrainMicros, Metrics::NowMicros() - start);
+
+        if (const auto dropped = g_dropped.load(std::memory_order_relaxed); dropped != g_reportedDrops) {
+            logger::warn("Hit inbox full: {} hits dropped so far (capacity {})", dropped, kInboxCapacity);
+            g_reportedDrops = dropped;
+        }
+    }
+}
@@ -1,16 +1,14 @@
 #include <Knockback/HitSink.h>
 
 #include <Knockback/Config.h>
-#include <Knockback/Filters.h>
-#include <Knockback/Tasks.h>
+#include <Knockback/GameWorld.h>
+#include <Knockback/HitInbox.h>
+#include <Knockback/Metrics.h>
+#include <Knockback/Scheduler.h>
 
 #include <RE/S/ScriptEventSourceHolder.h>
 #include <RE/T/TESHitEvent.h>
 
-#include <filesystem>
-#include <chrono>
-#include <mutex>
-
 namespace logger = SKSE::log;
 
 namespace Knockback
@@ -31,72 +29,31 @@ namespace Knockback
                 return RE::BSEventNotifyControl::kContinue;
             }
 
-            Knockback::MaybeReloadConfig();
-
-            RE::Actor* target = a_event->target ? a_event->target->As<RE::Actor>() : nullptr;
-            RE::Actor* aggressor = a_event->cause ? a_event->cause->As<RE::Actor>() : nullptr;
-
-            if (!target || !aggressor) return RE::BSEventNotifyControl::kContinue;
-            if (target == aggressor) {
-                logger::trace("Shove: target == aggressor");
+            if (!a_event->target || !a_event->cause) {
                 return RE::BSEventNotifyControl::kContinue;
             }
-            if (target->IsDead() || aggressor->IsDead()) return RE::BSEventNotifyControl::kContinue;
 
-            if (ShouldDisableDueToFirstPerson(aggressor)) return RE::BSEventNotifyControl::kContinue;
-
-            if (!IsValidKnockbackTarget(target)) {
-                logger::trace("Shove: target not allowed (humanoid filter)");
-                return RE::BSEventNotifyControl::kContinue;
-            }
+            // Enqueue only: classification happens in the per-frame drain (HitInbox.cpp).
+            RawHit hit{};
+            hit.target = a_event->target->GetHandle().native_handle();
+            hit.aggressor = a_event->cause->GetHandle().native_handle();
+            hit.source = a_event->source;
+            hit.projectile = a_event->projectile;
+            hit.flags = a_event->flags.any(RE::TESHitEvent::Flag::kPowerAttack) ? kRawHitPowerAttack : 0;
+            hit.frame = GetSchedulerFrame();
+            hit.postedMicros = Metrics::NowMicros();
+            PostHit(hit);
 
-            if (a_event->projectile != 0) {
-                logger::trace("Shove: skipped (projectile hit) projectile={:08X}", a_event->projectile);
-                return RE::BSEventNotifyControl::kContinue;
-            }
-
-            if (IsMagicSource(a_event->source)) {
-                logger::trace("Shove: skipped (magic source) source={:08X}", a_event->source);
-                return RE::BSEventNotifyControl::kContinue;
-            }
-
-            const auto* weap = ResolveWeaponFromEventOrEquipped(*a_event, aggressor);
-
-            const float weaponMult = GetWeaponMultiplier(weap);
-            if (weaponMult <= 0.0f) {
-                logger::trace("Shove: weapon is not configured");
-                return RE::BSEventNotifyControl::kContinue;
-            }
-
-            const auto& cfg = GetConfig();
-
-            float powerMult = 1.0f;
-            if (a_event->flags.any(RE::TESHitEvent::Flag::kPowerAttack)) {
-                powerMult = cfg.powerAttackMultiplier;  // add this to config/ini
-            }
-
-            logger::trace(
-                "Shove: queue target={:08X} aggressor={:08X} mag={} dur={} retries={} delayFrames={} DisableInFirstPerson={}",
-                target->GetFormID(), aggressor->GetFormID(),
-                cfg.shoveMagnitude * weaponMult * powerMult, cfg.shoveDuration,
-                cfg.shoveRetries, cfg.shoveRetryDelayFrames,
-                cfg.disableInFirstPerson);
-
-            QueuePhysicsShoveWithAttackDeferral(
-                aggressor->GetHandle(),
-                target->GetHandle(),
-                cfg.shoveRetries,
-                weaponMult * powerMult,
-				20);
-            
             return RE::BSEventNotifyControl::kContinue;
         }
     };
 
     void RegisterHitSink()
     {
-        InitKeywords();
+        SetWorld(GameWorld::GetSingleton());
+
         LoadConfig();
+        StartConfigWatcher();
 
         auto* holder = RE::ScriptEventSourceHolder::GetSingleton();
         if (!holder) {
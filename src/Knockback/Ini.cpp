@@ -0,0 +1,185 @@
+#include <Knockback/Ini.h>
+
+#include <charconv>
+#include <system_error>
+
+namespace Knockback::Ini
+{
+    static bool IsSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+    }
+
+    static char Lower(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    bool IEquals(std::string_view a, std::string_view b)
+    {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            if (Lower(a[i]) != Lower(b[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string_view Trim(std::string_view s)
+    {
+        while (!s.empty() && IsSpace(s.front())) {
+            s.remove_prefix(1);
+        }
+        while (!s.empty() && IsSpace(s.back())) {
+            s.remove_suffix(1);
+        }
+        return s;
+    }
+
+    std::string_view StripComment(std::string_view s)
+    {
+        const auto pos = s.find_first_of(";#");
+        return Trim(pos == std::string_view::npos ? s : s.substr(0, pos));
+    }
+
+    Document::Document(std::pmr::memory_resource* arena) :
+        _entries(arena)
+    {}
+
+    bool Document::Load(const std::filesystem::path& path)
+    {
+        _entries.clear();
+        _file.reset();
+        _file.emplace(path);
+        if (_file->size() == 0) {
+            return false;
+        }
+        Parse(_file->text());
+        return true;
+    }
+
+    void Document::Parse(std::string_view text)
+    {
+        // UTF-8 BOM
+        if (text.substr(0, 3) == "\xEF\xBB\xBF") {
+            text.remove_prefix(3);
+        }
+
+        std::string_view section{};
+        while (!text.empty()) {
+            const auto eol = text.find('\n');
+            const auto line = Trim(text.substr(0, eol));
+            text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
+
+            if (line.empty() || line.front() == ';' || line.front() == '#') {
+                continue;
+            }
+
+            if (line.front() == '[') {
+                const auto close = line.find(']');
+                if (close != std::string_view::npos) {
+                    section = Trim(line.substr(1, close - 1));
+                }
+                continue;
+            }
+
+            // Lines without '=' carry no value and are skipped, as SimpleIni does by default.
+            const auto eq = line.find('=');
+            if (eq == std::string_view::npos) {
+                continue;
+            }
+            const auto key = Trim(line.substr(0, eq));
+            if (!key.empty()) {
+                _entries.push_back(Entry{ section, key, Trim(line.substr(eq + 1)) });
+            }
+        }
+    }
+
+    std::optional<std::string_view> Document::Find(std::string_view section, std::string_view key) const
+    {
+        for (const auto& e : _entries) {
+            if (IEquals(e.key, key) && IEquals(e.section, section)) {
+                return e.value;
+            }
+        }
+        return std::nullopt;
+    }
+
+    template <class T, class... Base>
+    static bool FromCharsWhole(std::string_view s, T& out, Base... base)
+    {
+        // strtod/strtol take a leading '+'; from_chars does not.
+        if (s.size() > 1 && s.front() == '+' && s[1] != '-') {
+            s.remove_prefix(1);
+        }
+        T value{};
+        const auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), value, base...);
+        if (ec != std::errc{} || end != s.data() + s.size()) {
+            return false;
+        }
+        out = value;
+        return true;
+    }
+
+    bool ParseFloat(std::string_view s, float& out)
+    {
+        double value = 0.0;
+        if (s.empty() || !FromCharsWhole(s, value)) {
+            return false;
+        }
+        out = static_cast<float>(value);
+        return true;
+    }
+
+    bool ParseInt(std::string_view s, std::int32_t& out)
+    {
+        if (s.size() >= 2 && s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) {
+            return s.size() > 2 && FromCharsWhole(s.substr(2), out, 16);
+        }
+        return !s.empty() && FromCharsWhole(s, out, 10);
+    }
+
+    bool ParseBool(std::string_view s, bool& out)
+    {
+        if (s.empty()) {
+            return false;
+        }
+        switch (Lower(s[0])) {
+        case 't':
+        case 'y':
+        case '1':
+            out = true;
+            return true;
+        case 'f':
+        case 'n':
+        case '0':
+            out = false;
+            return true;
+        case 'o':
+            if (s.size() > 1 && Lower(s[1]) == 'n') {
+                out = true;
+                return true;
+            }
+            if (s.size() > 1 && Lower(s[1]) == 'f') {
+                out = false;
+                return true;
+            }
+            break;
+        }
+        return false;
+    }
+
+    bool ParseHexPrefix(std::string_view s, std::uint32_t& out)
+    {
+        std::uint32_t value = 0;
+        const auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), value, 16);
+        if (ec != std::errc{}) {
+            return false;
+        }
+        out = value;
+        return true;
+    }
+}
@@ -1,8 +1,15 @@
 #include <Knockback/Log.h>
 
+#include <Knockback/Adaptive.h>
+#include <Knockback/BinLog.h>
+#include <Knockback/Capture.h>
+#include <Knockback/GameWorld.h>
+#include <Knockback/Metrics.h>
+
 #include "SKSE/SKSE.h"
 #include <spdlog/logger.h>
 #include <spdlog/sinks/basic_file_sink.h>
+#include <chrono>
 #include <format>
 #include <memory>
 
@@ -25,4 +32,74 @@ namespace Knockback
         spdlog::set_level(spdlog::level::trace);
         spdlog::flush_on(spdlog::level::trace);
     }
+
+    void SetBinaryTrace(bool enabled)
+    {
+        if (enabled == BinLog::IsEnabled()) {
+            return;
+        }
+
+        if (!enabled) {
+            BinLog::Stop();
+            spdlog::flush_on(spdlog::level::trace);
+            return;
+        }
+
+        auto logsFolder = SKSE::log::log_directory();
+        if (!logsFolder) {
+            return;
+        }
+
+        auto pluginName = SKSE::PluginDeclaration::GetSingleton()->GetName();
+        if (BinLog::Start(*logsFolder / std::format("{}.kblog", pluginName))) {
+            // Trace lines no longer reach the text sink, so stop flushing it on every line.
+            spdlog::flush_on(spdlog::level::info);
+        }
+    }
+
+    void SetStatsInterval(std::int32_t seconds)
+    {
+        static std::int32_t current = 0;
+        if (seconds == current) {
+            return;
+        }
+        current = seconds;
+
+        if (seconds <= 0) {
+            Metrics::StopStatsWriter();
+            return;
+        }
+
+        auto logsFolder = SKSE::log::log_directory();
+        if (!logsFolder) {
+            return;
+        }
+
+        auto pluginName = SKSE::PluginDeclaration::GetSingleton()->GetName();
+        Metrics::StartStatsWriter(*logsFolder / std::format("{}.stats", pluginName), std::chrono::seconds(seconds), Adaptive::FormatTable);
+    }
+
+    void SetCaptureTrace(bool enabled)
+    {
+        static bool decided = false;
+        if (decided) {
+            if (enabled != Capture::IsActive()) {
+                SKSE::log::info("CaptureTrace change takes effect on the next launch");
+            }
+            return;
+        }
+        decided = true;
+
+        if (!enabled) {
+            return;
+        }
+
+        auto logsFolder = SKSE::log::log_directory();
+        if (!logsFolder) {
+            return;
+        }
+
+        auto pluginName = SKSE::PluginDeclaration::GetSingleton()->GetName();
+        Capture::Start(*logsFolder / std::format("{}.kbcap", pluginName), GameWorld::GetSingleton());
+    }
 }
@@ -0,0 +1,75 @@
+#include <Knockback/MappedFile.h>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Knockback
+{
+    MappedFile::MappedFile(const std::filesystem::path& path)
+    {
+#if defined(_WIN32)
+        // Share everything, like the fopen SimpleIni used: MCM Helper or an editor may save the
+        // file while it is open. Callers should still drop the map as soon as they are done.
+        const HANDLE file = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return;
+        }
+        _file = file;
+        LARGE_INTEGER size{};
+        if (!::GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+            return;
+        }
+        _mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!_mapping) {
+            return;
+        }
+        _data = static_cast<const std::uint8_t*>(::MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (_data) {
+            _size = static_cast<std::size_t>(size.QuadPart);
+        }
+#else
+        _fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (_fd < 0) {
+            return;
+        }
+        struct stat st{};
+        if (::fstat(_fd, &st) != 0 || st.st_size <= 0) {
+            return;
+        }
+        void* p = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, _fd, 0);
+        if (p != MAP_FAILED) {
+            _data = static_cast<const std::uint8_t*>(p);
+            _size = static_cast<std::size_t>(st.st_size);
+        }
+#endif
+    }
+
+    MappedFile::~MappedFile()
+    {
+#if defined(_WIN32)
+        if (_data) {
+            ::UnmapViewOfFile(_data);
+        }
+        if (_mapping) {
+            ::CloseHandle(_mapping);
+        }
+        if (_file) {
+            ::CloseHandle(_file);
+        }
+#else
+        if (_data) {
+            ::munmap(const_cast<std::uint8_t*>(_data), _size);
+        }
+        if (_fd >= 0) {
+            ::close(_fd);
+        }
+#endif
+    }
+}
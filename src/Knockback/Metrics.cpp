@@ -0,0 +1,378 @@
+#include <Knockback/Metrics.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if !defined(KNOCKBACK_HEADLESS)
+#include "SKSE/SKSE.h"
+namespace logger = SKSE::log;
+#endif
+
+namespace Knockback::Metrics
+{
+    namespace
+    {
+        constexpr std::array<std::string_view, kCounterCount> kCounterNames{
+            "hit.posted",
+            "hit.dropped",
+            "hit.projectile",
+            "hit.magic",
+            "hit.submitted",
+            "hit.self",
+            "hit.unresolved",
+            "hit.dead",
+            "hit.firstPerson",
+            "hit.invalidTarget",
+            "hit.noWeapon",
+            "chain.started",
+            "chain.merged",
+            "chain.superseded",
+            "job.stale",
+            "job.gated",
+            "deferral.poll",
+            "deferral.parked",
+            "deferral.woken",
+            "deferral.timedOut",
+            "attack.events",
+            "attack.eventsDropped",
+            "shove.applied",
+            "shove.failed",
+            "shove.retry",
+            "shove.exhausted",
+            "effect.ok",
+            "effect.reapply",
+            "effect.reapplyFailed",
+            "effect.exhausted",
+            "separation.ok",
+            "separation.push",
+            "separation.pushFailed",
+            "separation.noProgress",
+            "separation.exhausted",
+            "separation.gated",
+            "separation.merged",
+            "budget.deferred",
+            "budget.dropped",
+            "degrade.skipped",
+            "degrade.stepUp",
+            "degrade.stepDown",
+            "lod.near",
+            "lod.mid",
+            "lod.far",
+            "lod.farSkipped",
+            "lod.impulse",
+            "lod.impulseFailed",
+            "lod.effectSkipped",
+            "apply.degenerate",
+            "adaptive.triesCut",
+            "adaptive.delayRaised",
+            "adaptive.effectSkipped",
+            "adaptive.explore",
+            "weaponCache.hit",
+            "weaponCache.miss",
+        };
+
+        constexpr std::array<std::string_view, kHistogramCount> kHistogramNames{
+            "inbox.us",
+            "drain.us",
+            "deferral.frames",
+            "hitToImpulse.frames",
+            "hitToImpulse.us",
+            "shove.attempts",
+            "attack.victims",
+            "tick.jobs",
+            "tick.us",
+        };
+
+        constexpr std::array<std::string_view, kGaugeCount> kGaugeNames{
+            "jobs.live",
+            "jobs.highWater",
+            "jobs.poolCapacity",
+            "jobs.poolChunks",
+            "chains.live",
+            "chains.highWater",
+            "adaptive.keys",
+            "separation.pairs",
+            "separation.pairsHighWater",
+            "degrade.level",
+            "attack.watched",
+            "deferral.parkedLive",
+            "hit.pipeline",
+        };
+
+        // A name missing from any table would leave its last entry empty.
+        static_assert(!kCounterNames.back().empty() && !kHistogramNames.back().empty() && !kGaugeNames.back().empty());
+
+        std::array<std::atomic<std::uint64_t>, kGaugeCount> g_gauges{};
+
+        struct HistogramCells
+        {
+            std::array<std::atomic<std::uint64_t>, kBuckets> buckets{};
+            std::atomic<std::uint64_t> count{ 0 };
+            std::atomic<std::uint64_t> sum{ 0 };
+            std::atomic<std::uint64_t> max{ 0 };
+        };
+
+        // One per thread, written only by its owner. Never freed: a thread that exits
+        // keeps contributing what it recorded.
+        struct alignas(64) ThreadCells
+        {
+            std::array<std::atomic<std::uint64_t>, kCounterCount> counters{};
+            std::array<HistogramCells, kHistogramCount> histograms{};
+        };
+
+        std::mutex g_cellsMutex{};
+        std::vector<std::unique_ptr<ThreadCells>> g_cells{};
+
+        ThreadCells* RegisterThread()
+        {
+            auto cells = std::make_unique<ThreadCells>();
+            auto* raw = cells.get();
+
+            std::scoped_lock lock(g_cellsMutex);
+            g_cells.push_back(std::move(cells));
+            return raw;
+        }
+
+        ThreadCells& LocalCells()
+        {
+            static thread_local ThreadCells* const cells = RegisterThread();
+            return *cells;
+        }
+
+        // Single writer per cell, so no read-modify-write instruction is needed.
+        void Bump(std::atomic<std::uint64_t>& cell, std::uint64_t n)
+        {
+            cell.store(cell.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+        std::size_t BucketOf(std::uint64_t value)
+        {
+            return std::min<std::size_t>(static_cast<std::size_t>(std::bit_width(value)), kBuckets - 1);
+        }
+
+        std::uint64_t BucketUpperEdge(std::size_t bucket)
+        {
+            return bucket == 0 ? 0 : (std::uint64_t{ 1 } << bucket) - 1;
+        }
+
+        void ReportStatus(bool error, const std::string& msg)
+        {
+#if defined(KNOCKBACK_HEADLESS)
+            (void)error;
+            std::fprintf(stderr, "%s\n", msg.c_str());
+#else
+            if (error) {
+                logger::error("{}", msg);
+            }
+            else {
+                logger::info("{}", msg);
+            }
+#endif
+        }
+
+        // Headless builds target compilers without <format>; summaries are tiny anyway.
+        void AppendF(std::string& out, const char* fmt, ...)
+        {
+            char line[256];
+            std::va_list args;
+            va_start(args, fmt);
+            const int n = std::vsnprintf(line, sizeof(line), fmt, args);
+            va_end(args);
+            if (n > 0) {
+                out.append(line, std::min<std::size_t>(static_cast<std::size_t>(n), sizeof(line) - 1));
+            }
+        }
+
+        std::mutex g_writerMutex{};
+        std::condition_variable_any g_writerWake{};
+        std::jthread g_writer{};
+
+        void WriteSummary(std::FILE* file, const Snapshot& now, const Snapshot* previous, std::chrono::steady_clock::time_point started,
+            const std::function<std::string()>& appendix)
+        {
+            const auto uptime = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - started);
+            std::string text;
+            AppendF(text, "=== stats t+%llds ===\n", static_cast<long long>(uptime.count()));
+            text += Format(now, previous);
+            if (appendix) {
+                text += appendix();
+            }
+            text += '\n';
+            std::fwrite(text.data(), 1, text.size(), file);
+            std::fflush(file);
+        }
+
+        void WriterLoop(std::stop_token stop, std::FILE* file, std::chrono::seconds interval, std::function<std::string()> appendix)
+        {
+            const auto started = std::chrono::steady_clock::now();
+            Snapshot previous = Collect();
+
+            std::unique_lock lock(g_writerMutex);
+            while (!stop.stop_requested()) {
+                g_writerWake.wait_for(lock, stop, interval, []() { return false; });
+
+                const auto now = Collect();
+                WriteSummary(file, now, &previous, started, appendix);
+                previous = now;
+            }
+
+            std::fclose(file);
+        }
+    }
+
+    void Add(Counter counter, std::uint64_t n)
+    {
+        Bump(LocalCells().counters[static_cast<std::size_t>(counter)], n);
+    }
+
+    void Record(Histogram histogram, std::uint64_t value)
+    {
+        auto& h = LocalCells().histograms[static_cast<std::size_t>(histogram)];
+        Bump(h.buckets[BucketOf(value)], 1);
+        Bump(h.count, 1);
+        Bump(h.sum, value);
+        if (value > h.max.load(std::memory_order_relaxed)) {
+            h.max.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    void Set(Gauge gauge, std::uint64_t value)
+    {
+        g_gauges[static_cast<std::size_t>(gauge)].store(value, std::memory_order_relaxed);
+    }
+
+    std::uint64_t NowMicros()
+    {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    std::uint64_t HistogramSummary::Percentile(double p) const
+    {
+        if (count == 0) {
+            return 0;
+        }
+
+        const auto rank = static_cast<std::uint64_t>(p * static_cast<double>(count - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBuckets; ++i) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                return std::min(BucketUpperEdge(i), max);
+            }
+        }
+        return max;
+    }
+
+    Snapshot Collect()
+    {
+        Snapshot out{};
+        for (std::size_t i = 0; i < kGaugeCount; ++i) {
+            out.gauges[i] = g_gauges[i].load(std::memory_order_relaxed);
+        }
+
+        std::scoped_lock lock(g_cellsMutex);
+        for (const auto& cells : g_cells) {
+            for (std::size_t i = 0; i < kCounterCount; ++i) {
+                out.counters[i] += cells->counters[i].load(std::memory_order_relaxed);
+            }
+            for (std::size_t i = 0; i < kHistogramCount; ++i) {
+                const auto& src = cells->histograms[i];
+                auto& dst = out.histograms[i];
+                for (std::size_t b = 0; b < kBuckets; ++b) {
+                    dst.buckets[b] += src.buckets[b].load(std::memory_order_relaxed);
+                }
+                dst.count += src.count.load(std::memory_order_relaxed);
+                dst.sum += src.sum.load(std::memory_order_relaxed);
+                dst.max = std::max(dst.max, src.max.load(std::memory_order_relaxed));
+            }
+        }
+        return out;
+    }
+
+    std::string_view CounterName(Counter counter)
+    {
+        return kCounterNames[static_cast<std::size_t>(counter)];
+    }
+
+    std::string_view HistogramName(Histogram histogram)
+    {
+        return kHistogramNames[static_cast<std::size_t>(histogram)];
+    }
+
+    std::string_view GaugeName(Gauge gauge)
+    {
+        return kGaugeNames[static_cast<std::size_t>(gauge)];
+    }
+
+    std::string Format(const Snapshot& now, const Snapshot* previous)
+    {
+        using ull = unsigned long long;
+        std::string out;
+
+        for (std::size_t i = 0; i < kCounterCount; ++i) {
+            const auto name = kCounterNames[i];
+            if (previous) {
+                AppendF(out, "%-24.*s%12llu (+%llu)\n", static_cast<int>(name.size()), name.data(),
+                    static_cast<ull>(now.counters[i]), static_cast<ull>(now.counters[i] - previous->counters[i]));
+            }
+            else {
+                AppendF(out, "%-24.*s%12llu\n", static_cast<int>(name.size()), name.data(), static_cast<ull>(now.counters[i]));
+            }
+        }
+
+        for (std::size_t i = 0; i < kGaugeCount; ++i) {
+            const auto name = kGaugeNames[i];
+            AppendF(out, "%-24.*s%12llu\n", static_cast<int>(name.size()), name.data(), static_cast<ull>(now.gauges[i]));
+        }
+
+        AppendF(out, "%-24s%10s%12s%10s%10s%10s%10s\n", "histogram", "count", "mean", "p50", "p90", "p99", "max");
+        for (std::size_t i = 0; i < kHistogramCount; ++i) {
+            const auto name = kHistogramNames[i];
+            const auto& h = now.histograms[i];
+            AppendF(out, "%-24.*s%10llu%12.1f%10llu%10llu%10llu%10llu\n", static_cast<int>(name.size()), name.data(),
+                static_cast<ull>(h.count), h.Mean(), static_cast<ull>(h.Percentile(0.5)), static_cast<ull>(h.Percentile(0.9)),
+                static_cast<ull>(h.Percentile(0.99)), static_cast<ull>(h.max));
+        }
+        return out;
+    }
+
+    bool StartStatsWriter(const std::filesystem::path& path, std::chrono::seconds interval, std::function<std::string()> appendix)
+    {
+        StopStatsWriter();
+
+        if (interval.count() <= 0) {
+            return false;
+        }
+
+        std::FILE* file = std::fopen(path.string().c_str(), "w");
+        if (!file) {
+            ReportStatus(true, "Metrics: could not open " + path.string());
+            return false;
+        }
+
+        g_writer = std::jthread(WriterLoop, file, interval, std::move(appendix));
+        ReportStatus(false, "Metrics: stats every " + std::to_string(interval.count()) + "s -> " + path.string());
+        return true;
+    }
+
+    void StopStatsWriter()
+    {
+        if (!g_writer.joinable()) {
+            return;
+        }
+
+        g_writer.request_stop();
+        g_writer.join();
+    }
+}
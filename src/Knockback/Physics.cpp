@@ -1,29 +1,21 @@
 #include <Knockback/Physics.h>
-#include <Knockback/Config.h>
+#include <Knockback/BinLog.h>
+#include <Knockback/Metrics.h>
 
-#include "SKSE/SKSE.h"
-#include <xmmintrin.h>
 #include <cmath>
 #include <algorithm>
 
-namespace logger = SKSE::log;
-
 namespace Knockback
 {
-    float HorizontalDistance(RE::Actor* a, RE::Actor* b)
+    float HorizontalDistance(const Vec3& a, const Vec3& b)
     {
-        if (!a || !b) return 0.0f;
-        const auto ap = a->GetPosition();
-        const auto bp = b->GetPosition();
-        const float dx = bp.x - ap.x;
-        const float dy = bp.y - ap.y;
+        const float dx = b.x - a.x;
+        const float dy = b.y - a.y;
         return std::sqrt(dx * dx + dy * dy);
     }
 
-    void ShapeForApplyCurrent(float& mag, float& dur)
+    void ShapeForApplyCurrent(const Settings& cfg, float& mag, float& dur)
     {
-        const auto& cfg = GetConfig();
-
         if (cfg.applyCurrentMinVelocity > 0.0f && mag > 0.0f) {
             const float peak = std::max(mag, cfg.applyCurrentMinVelocity);
             const float scaled = dur * (mag / peak);
@@ -33,76 +25,15 @@ namespace Knockback
         }
     }
 
-    bool ApplyPhysicsShove(RE::Actor* aggressor, RE::Actor* target, float magnitude, float duration)
+    bool ApplyPhysicsShove(IWorld& world, ActorId target, float dirX, float dirY, float magnitude, float duration)
     {
-        if (!aggressor || !target) {
-            logger::trace("ApplyPhysicsShove: null aggressor/target");
-            return false;
-        }
-
-        if (aggressor == target) {
-            return false;
-        }
-
-        // Basic lifecycle sanity (cheap + prevents weird edge cases)
-        if (target->IsDead() || aggressor->IsDead()) {
-            return false;
-        }
-
-        // Physics/3D validity gates (avoid ApplyCurrent crash paths)
-        if (!target->Is3DLoaded()) {
-            logger::trace("ApplyPhysicsShove: target not 3D loaded {:08X}", target->GetFormID());
-            return false;
-        }
-
-        auto* node = target->Get3D();
-        if (!node) {
-            logger::trace("ApplyPhysicsShove: target has no 3D {:08X}", target->GetFormID());
+        if (dirX == 0.0f && dirY == 0.0f) {
+            Metrics::Add(Metrics::Counter::kApplyDegenerate);
+            KB_TRACE("ApplyPhysicsShove: degenerate dir (actors overlap) target={:08X}", target);
             return false;
         }
 
-        // controller gate. 
-        auto* cc = target->GetCharController();
-        if (!cc) {
-            logger::trace("ApplyPhysicsShove: no char controller {:08X}", target->GetFormID());
-            return false;
-        }
-
-        // Direction from aggressor -> target
-        const auto aPos = aggressor->GetPosition();
-        const auto tPos = target->GetPosition();
-
-        float dx = tPos.x - aPos.x;
-        float dy = tPos.y - aPos.y;
-        float dz = 0.0f;  // flatten vertical
-
-        const float lenSq = dx * dx + dy * dy;
-        if (lenSq < 1e-6f) {
-            logger::trace("ApplyPhysicsShove: degenerate dir (aPos=({},{}), tPos=({},{}), lenSq={})",
-                aPos.x, aPos.y, tPos.x, tPos.y, lenSq);
-            return false;
-        }
-
-        const float invLen = 1.0f / std::sqrt(lenSq);
-        dx *= invLen;
-        dy *= invLen;
-
-        RE::hkVector4 vel{};
-        vel.quad = _mm_setr_ps(dx * magnitude, dy * magnitude, dz, 0.0f);
-
-        logger::trace("ApplyPhysicsShove: applying vel=({}, {}, {}) mag={} dur={} to target {:08X}",
-            vel.quad.m128_f32[0],
-            vel.quad.m128_f32[1],
-            vel.quad.m128_f32[2],
-            magnitude,
-            duration,
-			target->GetFormID());
-        return target->ApplyCurrent(duration, vel);
-    }
-
-
-    bool ApplyVelocityAwayFrom(RE::Actor* from, RE::Actor* who, float magnitude, float duration)
-    {
-        return ApplyPhysicsShove(from, who, magnitude, duration);
+        const float dz = 0.0f;  // flatten vertical
+        return world.ApplyCurrent(target, Vec3{ dirX * magnitude, dirY * magnitude, dz }, duration);
     }
 }
@@ -0,0 +1,130 @@
+#include <Knockback/Registry.h>
+
+#include <Knockback/Scheduler.h>
+
+#include <algorithm>
+#include <memory_resource>
+#include <mutex>
+#include <unordered_map>
+
+namespace Knockback
+{
+    struct ChainEntry
+    {
+        ShoveChain chain;
+        SettingsPtr pinned;
+        std::int32_t outstanding{ 0 };
+    };
+
+    // Entries come and go with every fight; their map nodes are recycled by the pool
+    // resource instead of going back to the heap (guarded by g_chainsMutex like the map).
+    static std::pmr::unsynchronized_pool_resource g_chainNodes{};
+    static std::pmr::unordered_map<std::uint32_t, ChainEntry> g_chains{ &g_chainNodes };
+    static std::size_t g_chainsHighWater{ 0 };
+    static std::mutex g_chainsMutex{};
+    static std::uint32_t g_nextGeneration{ 1 };
+
+    ChainBegin BeginShoveChain(
+        ActorId target,
+        ActorId aggressor,
+        float weaponMult,
+        SettingsPtr cfg,
+        std::uint64_t hitMicros,
+        std::uint32_t& outGeneration)
+    {
+        std::scoped_lock lock(g_chainsMutex);
+
+        auto [it, inserted] = g_chains.try_emplace(target);
+        auto& entry = it->second;
+        g_chainsHighWater = std::max(g_chainsHighWater, g_chains.size());
+
+        entry.chain.aggressor = aggressor;
+        entry.chain.weaponMult = weaponMult;
+
+        // Still waiting to shove: the queued jobs will read the refreshed values.
+        if (!inserted && !entry.chain.shoveApplied) {
+            outGeneration = entry.chain.generation;
+            return ChainBegin::kUpdated;
+        }
+
+        entry.pinned = std::move(cfg);
+        entry.chain.cfg = entry.pinned.get();
+        entry.chain.generation = g_nextGeneration++;
+        entry.chain.shoveApplied = false;
+        entry.chain.startFrame = GetSchedulerFrame();
+        entry.chain.hitMicros = hitMicros;
+        ++entry.outstanding;
+
+        outGeneration = entry.chain.generation;
+        return inserted ? ChainBegin::kStarted : ChainBegin::kSuperseded;
+    }
+
+    bool LookupShoveChain(ActorId target, std::uint32_t generation, ShoveChain& out)
+    {
+        std::scoped_lock lock(g_chainsMutex);
+
+        const auto it = g_chains.find(target);
+        if (it == g_chains.end() || it->second.chain.generation != generation) {
+            return false;
+        }
+
+        out = it->second.chain;
+        return true;
+    }
+
+    void MarkShoveApplied(ActorId target, std::uint32_t generation)
+    {
+        std::scoped_lock lock(g_chainsMutex);
+
+        const auto it = g_chains.find(target);
+        if (it != g_chains.end() && it->second.chain.generation == generation) {
+            it->second.chain.shoveApplied = true;
+        }
+    }
+
+    SettingsPtr GetShoveChainSettings(ActorId target, std::uint32_t generation)
+    {
+        std::scoped_lock lock(g_chainsMutex);
+
+        const auto it = g_chains.find(target);
+        if (it == g_chains.end() || it->second.chain.generation != generation) {
+            return nullptr;
+        }
+        return it->second.pinned;
+    }
+
+    void RetainShoveChain(ActorId target)
+    {
+        std::scoped_lock lock(g_chainsMutex);
+
+        if (const auto it = g_chains.find(target); it != g_chains.end()) {
+            ++it->second.outstanding;
+        }
+    }
+
+    void ReleaseShoveChain(ActorId target)
+    {
+        std::scoped_lock lock(g_chainsMutex);
+
+        const auto it = g_chains.find(target);
+        if (it == g_chains.end()) {
+            return;
+        }
+
+        if (--it->second.outstanding <= 0) {
+            g_chains.erase(it);
+        }
+    }
+
+    std::size_t GetActiveShoveChainCount()
+    {
+        std::scoped_lock lock(g_chainsMutex);
+        return g_chains.size();
+    }
+
+    std::size_t GetShoveChainHighWater()
+    {
+        std::scoped_lock lock(g_chainsMutex);
+        return g_chainsHighWater;
+    }
+}
@@ -0,0 +1,142 @@
+#include <Knockback/Scheduler.h>
+
+#include <Knockback/AttackTracker.h>
+#include <Knockback/BinLog.h>
+#include <Knockback/Pool.h>
+#include <Knockback/Separation.h>
+#include <Knockback/Tasks.h>
+#include <Knockback/World.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace Knockback
+{
+    // Frame-indexed timer wheel. A job due at frame F lives in slot F % kWheelSlots;
+    // delays longer than the wheel just stay in their slot until the due frame comes around.
+    constexpr std::size_t kWheelSlots = 64;
+    static_assert((kWheelSlots & (kWheelSlots - 1)) == 0, "wheel size must be a power of two");
+
+    struct PendingJob
+    {
+        Job job;
+        std::uint64_t dueFrame{ 0 };
+    };
+
+    // Job records live in a pool; each wheel slot is a FIFO threaded through the pool's links,
+    // so scheduling and retiring a job never touches the heap once the pool has grown.
+    using JobPool = SlabPool<PendingJob>;
+
+    struct WheelSlot
+    {
+        JobPool::Index head{ JobPool::kNone };
+        JobPool::Index tail{ JobPool::kNone };
+    };
+
+    static JobPool g_jobs{};
+    static std::array<WheelSlot, kWheelSlots> g_wheel{};
+    static std::vector<Job> g_due{};
+    static std::mutex g_wheelMutex{};
+    // Written under g_wheelMutex; atomic so hit producers can stamp it without the lock.
+    static std::atomic<std::uint64_t> g_frame{ 0 };
+    static std::size_t g_pending{ 0 };
+    static std::atomic_bool g_tickQueued{ false };
+
+    static void Tick();
+
+    // One drain task per frame, and only while something is pending (jobs, or separation pairs).
+    static void EnsureTickQueued()
+    {
+        if (g_tickQueued.exchange(true)) {
+            return;
+        }
+
+        if (!GetWorld().AddTask([]() { Tick(); })) {
+            g_tickQueued = false;
+            KB_TRACE("Scheduler: no task queue");
+        }
+    }
+
+    static void Tick()
+    {
+        // Clear first so jobs scheduled by the handlers below re-arm the next tick.
+        g_tickQueued = false;
+
+        {
+            std::scoped_lock lock(g_wheelMutex);
+
+            const auto frame = g_frame.fetch_add(1, std::memory_order_relaxed) + 1;
+            auto& slot = g_wheel[frame & (kWheelSlots - 1)];
+
+            // Unlink what is due, in scheduling order; later laps of the wheel stay put.
+            g_due.clear();
+            auto prev = JobPool::kNone;
+            for (auto i = slot.head; i != JobPool::kNone;) {
+                const auto next = g_jobs.Link(i);
+                if (g_jobs[i].dueFrame != frame) {
+                    prev = i;
+                    i = next;
+                    continue;
+                }
+
+                g_due.push_back(g_jobs[i].job);
+                (prev == JobPool::kNone ? slot.head : g_jobs.Link(prev)) = next;
+                if (slot.tail == i) {
+                    slot.tail = prev;
+                }
+                g_jobs.Release(i);
+                i = next;
+            }
+            g_pending -= g_due.size();
+        }
+
+        RunJobs(g_due);
+
+        bool more = false;
+        {
+            std::scoped_lock lock(g_wheelMutex);
+            more = g_pending > 0;
+        }
+        more = more || Separation::ActivePairCount() > 0 || Attacks::ParkedCount() > 0;
+        if (more) {
+            EnsureTickQueued();
+        }
+    }
+
+    void ScheduleJob(const Job& job, std::int32_t delayFrames)
+    {
+        {
+            std::scoped_lock lock(g_wheelMutex);
+
+            const auto due = g_frame.load(std::memory_order_relaxed) + 1 + static_cast<std::uint64_t>(std::max(0, delayFrames));
+            const auto i = g_jobs.Acquire();
+            g_jobs[i] = PendingJob{ job, due };
+
+            auto& slot = g_wheel[due & (kWheelSlots - 1)];
+            (slot.tail == JobPool::kNone ? slot.head : g_jobs.Link(slot.tail)) = i;
+            slot.tail = i;
+            ++g_pending;
+        }
+        EnsureTickQueued();
+    }
+
+    std::uint64_t GetSchedulerFrame()
+    {
+        return g_frame.load(std::memory_order_relaxed);
+    }
+
+    std::size_t GetPendingJobCount()
+    {
+        std::scoped_lock lock(g_wheelMutex);
+        return g_pending;
+    }
+
+    PoolStats GetJobPoolStats()
+    {
+        std::scoped_lock lock(g_wheelMutex);
+        return g_jobs.Stats();
+    }
+}
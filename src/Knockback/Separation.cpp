@@ -0,0 +1,285 @@
+#include <Knockback/Separation.h>
+
+#include <Knockback/BinLog.h>
+#include <Knockback/Metrics.h>
+#include <Knockback/Physics.h>
+#include <Knockback/ShoveKernel.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory_resource>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Knockback::Separation
+{
+    struct Pair
+    {
+        ActorId aggressor{ 0 };
+        ActorId target{ 0 };
+        SettingsPtr cfg;
+        std::uint64_t dueFrame{ 0 };
+        float lastDist{ -1.0f };        // -1 until the first update measured it
+        std::int32_t triesLeft{ 0 };
+        std::int32_t noProgress{ 0 };   // consecutive updates that moved less than a unit
+        bool retire{ false };
+    };
+
+    // One update's view of a due pair; lane indexes g_batch.
+    struct DuePair
+    {
+        std::uint32_t pair{ 0 };
+        std::size_t lane{ 0 };
+    };
+
+    // All pushes wanted for one aggressor this update, applied as a single ApplyCurrent.
+    struct NetPush
+    {
+        ActorId aggressor{ 0 };
+        float sumX{ 0.0f };
+        float sumY{ 0.0f };
+        float dirX{ 0.0f };           // the only pair's direction, used as is when pairs == 1
+        float dirY{ 0.0f };
+        float magnitude{ 0.0f };
+        float duration{ 0.0f };
+        std::uint32_t pairs{ 0 };
+    };
+
+    // Main-thread only. Pairs are dense and swap-removed; g_index maps (aggressor, target)
+    // to the slot and recycles its nodes like the chain registry does.
+    static std::vector<Pair> g_pairs{};
+    static std::pmr::unsynchronized_pool_resource g_indexNodes{};
+    static std::pmr::unordered_map<std::uint64_t, std::uint32_t> g_index{ &g_indexNodes };
+    static std::size_t g_highWater{ 0 };
+
+    // Per update; capacity is reused from frame to frame.
+    static ShoveBatch g_batch{};
+    static std::vector<DuePair> g_due{};
+    static std::vector<NetPush> g_pushes{};
+
+    static std::uint64_t PairKey(ActorId aggressor, ActorId target)
+    {
+        return (static_cast<std::uint64_t>(aggressor) << 32) | target;
+    }
+
+    void Engage(SettingsPtr cfg, ActorId aggressor, ActorId target, std::uint64_t frame)
+    {
+        if (!cfg || !cfg->enforceMinSeparation || cfg->minSeparationDistance <= 0.0f || cfg->separationRetries <= 0) {
+            return;
+        }
+
+        const auto [it, inserted] = g_index.try_emplace(PairKey(aggressor, target), static_cast<std::uint32_t>(g_pairs.size()));
+        if (inserted) {
+            g_pairs.emplace_back();
+            g_highWater = std::max(g_highWater, g_pairs.size());
+        }
+
+        // A fresh shove restarts the pair as if it were new.
+        auto& pair = g_pairs[it->second];
+        pair.aggressor = aggressor;
+        pair.target = target;
+        pair.dueFrame = frame + 1 + static_cast<std::uint64_t>(std::max(0, cfg->separationInitialDelayFrames));
+        pair.lastDist = -1.0f;
+        pair.triesLeft = cfg->separationRetries;
+        pair.noProgress = 0;
+        pair.retire = false;
+        pair.cfg = std::move(cfg);
+    }
+
+    // Player aggressor memo: every pair of one aggressor reads its state once per update.
+    struct AggressorView
+    {
+        ActorId id{ 0 };
+        bool usable{ false };
+        ActorState state;
+        const Settings* cfg{ nullptr };
+        bool firstPerson{ false };
+    };
+
+    // The gates a separation job used to pass: both ends resolve, are distinct and alive,
+    // the aggressor is the player and not suppressed in first person, the target is valid.
+    static bool PassesGates(IWorld& world, const Pair& pair, AggressorView& view, ActorState& target)
+    {
+        if (pair.aggressor == pair.target) return false;
+
+        if (view.id != pair.aggressor) {
+            view = AggressorView{};
+            view.id = pair.aggressor;
+            view.usable = world.GetActorState(pair.aggressor, view.state) && !view.state.dead && view.state.player;
+        }
+        if (!view.usable) return false;
+
+        if (!world.GetActorState(pair.target, target) || target.dead) return false;
+
+        if (view.cfg != pair.cfg.get()) {
+            view.cfg = pair.cfg.get();
+            view.firstPerson = pair.cfg->disableInFirstPerson && world.SuppressedByFirstPerson(*pair.cfg, pair.aggressor);
+        }
+        if (view.firstPerson) return false;
+
+        return world.IsValidTarget(*pair.cfg, pair.target);
+    }
+
+    static NetPush& PushFor(ActorId aggressor)
+    {
+        // Separation is player-only, so this is one entry in practice.
+        for (auto& push : g_pushes) {
+            if (push.aggressor == aggressor) {
+                return push;
+            }
+        }
+        auto& push = g_pushes.emplace_back();
+        push.aggressor = aggressor;
+        return push;
+    }
+
+    // Decides one measured pair; a pair that still needs room adds its push to the aggressor's.
+    static void Step(Pair& pair, float dist, float dirX, float dirY, float magnitude, float duration, std::uint64_t frame)
+    {
+        const auto& cfg = *pair.cfg;
+        const float minDist = cfg.minSeparationDistance;
+
+        if (pair.lastDist >= 0.0f) {
+            const float delta = std::fabs(dist - pair.lastDist);
+            pair.noProgress = (delta < 1.0f) ? pair.noProgress + 1 : 0;
+
+            if (pair.noProgress >= 2) {
+                Metrics::Add(Metrics::Counter::kSeparationNoProgress);
+                KB_TRACE("Separation: no progress (dist={} lastDist={} delta={}) -> stop",
+                    dist, pair.lastDist, delta);
+                pair.retire = true;
+                return;
+            }
+        }
+
+        if (dist >= minDist) {
+            Metrics::Add(Metrics::Counter::kSeparationOk);
+            KB_TRACE("Separation: ok dist={} (min={})", dist, minDist);
+            pair.retire = true;
+            return;
+        }
+
+        // Push the aggressor away from the target: the reverse of the batch direction.
+        auto& push = PushFor(pair.aggressor);
+        push.sumX -= dirX * magnitude;
+        push.sumY -= dirY * magnitude;
+        push.dirX = -dirX;
+        push.dirY = -dirY;
+        push.magnitude = std::max(push.magnitude, magnitude);
+        push.duration = std::max(push.duration, duration);
+        ++push.pairs;
+
+        KB_TRACE("Separation: dist={} deficit={} -> pushAggressor mag={} dur={} triesLeftAfter={}",
+            dist, minDist - dist, magnitude, duration, pair.triesLeft - 1);
+
+        pair.lastDist = dist;
+        if (--pair.triesLeft > 0) {
+            pair.dueFrame = frame + 1 + static_cast<std::uint64_t>(std::max(0, cfg.separationRetryDelayFrames));
+        }
+        else {
+            Metrics::Add(Metrics::Counter::kSeparationExhausted);
+            pair.retire = true;
+        }
+    }
+
+    // One ApplyCurrent per aggressor. Pairs on the same side add up to their common
+    // direction at the speed of the most urgent one; pairs on opposite sides cancel, and a
+    // push that cancels out is refused by ApplyPhysicsShove like any degenerate direction.
+    static void ApplyPushes(IWorld& world)
+    {
+        for (const auto& push : g_pushes) {
+            float dirX = push.dirX;
+            float dirY = push.dirY;
+            if (push.pairs > 1) {
+                const float len = std::sqrt(push.sumX * push.sumX + push.sumY * push.sumY);
+                dirX = len > 1e-4f ? push.sumX / len : 0.0f;
+                dirY = len > 1e-4f ? push.sumY / len : 0.0f;
+                Metrics::Add(Metrics::Counter::kSeparationMerged, push.pairs - 1);
+            }
+
+            const bool ok = ApplyPhysicsShove(world, push.aggressor, dirX, dirY, push.magnitude, push.duration);
+            Metrics::Add(ok ? Metrics::Counter::kSeparationPush : Metrics::Counter::kSeparationPushFailed);
+            KB_TRACE("Separation: push aggressor={:08X} pairs={} mag={} dur={} ok={}",
+                push.aggressor, push.pairs, push.magnitude, push.duration, ok);
+        }
+    }
+
+    static void RetirePairs()
+    {
+        for (std::size_t i = g_pairs.size(); i-- > 0;) {
+            if (!g_pairs[i].retire) {
+                continue;
+            }
+
+            g_index.erase(PairKey(g_pairs[i].aggressor, g_pairs[i].target));
+            if (i + 1 != g_pairs.size()) {
+                g_pairs[i] = std::move(g_pairs.back());
+                g_index[PairKey(g_pairs[i].aggressor, g_pairs[i].target)] = static_cast<std::uint32_t>(i);
+            }
+            g_pairs.pop_back();
+        }
+    }
+
+    void Update(IWorld& world, std::uint64_t frame)
+    {
+        if (g_pairs.empty()) {
+            return;
+        }
+
+        g_batch.clear();
+        g_due.clear();
+        g_pushes.clear();
+
+        // Pass 1: gate the due pairs and gather their geometry.
+        AggressorView view{};
+        for (std::size_t i = 0; i < g_pairs.size(); ++i) {
+            auto& pair = g_pairs[i];
+            if (pair.dueFrame > frame) {
+                continue;
+            }
+
+            ActorState target{};
+            if (!PassesGates(world, pair, view, target)) {
+                Metrics::Add(Metrics::Counter::kSeparationGated);
+                pair.retire = true;
+                continue;
+            }
+            const auto lane = g_batch.AddSeparation(view.state.position, target.position, *pair.cfg);
+            g_due.push_back(DuePair{ static_cast<std::uint32_t>(i), lane });
+        }
+
+        if (!g_due.empty()) {
+            // Pass 2: distances, directions and deficit-shaped magnitudes in one sweep.
+            ComputeShoveGeometry(g_batch);
+
+            // Pass 3: per-pair decisions, then one push per aggressor.
+            for (const auto& d : g_due) {
+                const auto l = d.lane;
+                Step(g_pairs[d.pair], g_batch.distance[l], g_batch.dirX[l], g_batch.dirY[l],
+                    g_batch.magnitude[l], g_batch.duration[l], frame);
+            }
+            ApplyPushes(world);
+        }
+
+        RetirePairs();
+    }
+
+    std::size_t Clear()
+    {
+        const auto dropped = g_pairs.size();
+        g_pairs.clear();
+        g_index.clear();
+        return dropped;
+    }
+
+    std::size_t ActivePairCount()
+    {
+        return g_pairs.size();
+    }
+
+    std::size_t PairHighWater()
+    {
+        return g_highWater;
+    }
+}
@@ -0,0 +1,197 @@
+#include <Knockback/SettingsSchema.h>
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstdio>
+
+namespace Knockback::Schema
+{
+    namespace
+    {
+        constexpr double kInf = std::numeric_limits<double>::infinity();
+
+        constexpr Field Float(std::string_view section, std::string_view key, float Settings::*m, bool mcm = false,
+            double min = -kInf, double max = kInf)
+        {
+            Field f{ section, key, Type::kFloat };
+            f.f = m;
+            f.min = min;
+            f.max = max;
+            f.mcm = mcm;
+            return f;
+        }
+
+        constexpr Field Int(std::string_view section, std::string_view key, std::int32_t Settings::*m, bool mcm = false,
+            double min = -kInf, double max = kInf)
+        {
+            Field f{ section, key, Type::kInt };
+            f.i = m;
+            f.min = min;
+            f.max = max;
+            f.mcm = mcm;
+            return f;
+        }
+
+        constexpr Field Bool(std::string_view section, std::string_view key, bool Settings::*m, bool mcm = false)
+        {
+            Field f{ section, key, Type::kBool };
+            f.b = m;
+            f.mcm = mcm;
+            return f;
+        }
+
+        constexpr bool kMcm = true;
+
+        // MCM order is the order the seeded file lists them in.
+        const std::array kFields{
+            Float("General", "ShoveMagnitude", &Settings::shoveMagnitude, kMcm),
+            Float("General", "ShoveDuration", &Settings::shoveDuration, kMcm),
+            Float("General", "MinShoveSeparationDelta", &Settings::minShoveSeparationDelta, kMcm),
+            Float("General", "ApplyCurrentMinVelocity", &Settings::applyCurrentMinVelocity, kMcm),
+            Float("General", "MinDurationScale", &Settings::minDurationScale, kMcm),
+            Int("General", "ShoveRetries", &Settings::shoveRetries, kMcm, 0, 10),
+            Int("General", "ShoveRetryDelayFrames", &Settings::shoveRetryDelayFrames, kMcm),
+            Int("General", "ShoveInitialDelayFrames", &Settings::shoveInitialDelayFrames, kMcm),
+            Bool("General", "DisableInFirstPerson", &Settings::disableInFirstPerson, kMcm),
+            Bool("General", "EnforceMinSeparation", &Settings::enforceMinSeparation, kMcm),
+            Float("General", "MinSeparationDistance", &Settings::minSeparationDistance, kMcm),
+            Float("General", "SeparationPushDuration", &Settings::separationPushDuration, kMcm),
+            Float("General", "SeparationMaxVelocity", &Settings::separationMaxVelocity, kMcm),
+            Int("General", "SeparationRetries", &Settings::separationRetries, kMcm),
+            Int("General", "SeparationInitialDelayFrames", &Settings::separationInitialDelayFrames, kMcm),
+            Int("General", "SeparationRetryDelayFrames", &Settings::separationRetryDelayFrames, kMcm),
+            Float("WeaponMultipliers", "Unarmed", &Settings::unarmedMultiplier, kMcm),
+            Float("WeaponMultipliers", "PowerAttack", &Settings::powerAttackMultiplier, kMcm),
+
+            Bool("General", "AdaptiveRetries", &Settings::adaptiveRetries),
+            Int("General", "AdaptiveMinRetries", &Settings::adaptiveMinRetries),
+            Int("General", "AdaptiveMaxInitialDelayFrames", &Settings::adaptiveMaxInitialDelayFrames),
+            Int("General", "FrameBudgetJobs", &Settings::frameBudgetJobs, false, 0),
+            Int("General", "FrameBudgetMicros", &Settings::frameBudgetMicros, false, 0),
+            Bool("General", "FrameBudgetDegrade", &Settings::frameBudgetDegrade),
+            Float("General", "LodMidDistance", &Settings::lodMidDistance, false, 0),
+            Float("General", "LodFarDistance", &Settings::lodFarDistance, false, 0),
+            Bool("General", "LodFarImpulse", &Settings::lodFarImpulse),
+
+            Bool("Logging", "AsyncBinaryTrace", &Settings::asyncBinaryTrace),
+            Int("Logging", "StatsInterval", &Settings::statsIntervalSeconds),
+            Bool("Logging", "CaptureTrace", &Settings::captureTrace),
+        };
+        static_assert(kFields.size() <= 64, "Apply tracks fields in a 64-bit set");
+
+        constexpr char TypeLetter(Type type)
+        {
+            return type == Type::kFloat ? 'f' : type == Type::kInt ? 'i' : 'b';
+        }
+
+        // 0: not this field, 1: plain key, 2: typed key (MCM only).
+        int Match(const Field& field, const Ini::Entry& e, Layer layer)
+        {
+            if (layer == Layer::kMcm) {
+                if (!field.mcm) {
+                    return 0;
+                }
+                if (e.key.size() == field.key.size() + 1 && (e.key[0] | 0x20) == TypeLetter(field.type) &&
+                    Ini::IEquals(e.key.substr(1), field.key) && Ini::IEquals(e.section, field.section)) {
+                    return 2;
+                }
+            }
+            return Ini::IEquals(e.key, field.key) && Ini::IEquals(e.section, field.section) ? 1 : 0;
+        }
+
+        void Set(const Field& field, std::string_view value, Settings& out)
+        {
+            switch (field.type) {
+            case Type::kFloat:
+                Ini::ParseFloat(value, out.*field.f);
+                break;
+            case Type::kInt:
+                Ini::ParseInt(value, out.*field.i);
+                break;
+            case Type::kBool:
+                Ini::ParseBool(value, out.*field.b);
+                break;
+            }
+        }
+    }
+
+    std::span<const Field> Fields()
+    {
+        return kFields;
+    }
+
+    std::size_t Apply(const Ini::Document& doc, Layer layer, Settings& out)
+    {
+        std::bitset<64> plain{};
+        std::bitset<64> typed{};
+
+        for (const auto& e : doc.Entries()) {
+            for (std::size_t i = 0; i < kFields.size(); ++i) {
+                const auto match = Match(kFields[i], e, layer);
+                if (match == 0) {
+                    continue;
+                }
+
+                // A typed key overrides a plain one wherever it appears; otherwise first wins.
+                if (match == 2 ? !typed[i] : !typed[i] && !plain[i]) {
+                    Set(kFields[i], e.value, out);
+                }
+                (match == 2 ? typed : plain).set(i);
+                break;
+            }
+        }
+        return (plain | typed).count();
+    }
+
+    void Clamp(Settings& s)
+    {
+        for (const auto& field : kFields) {
+            if (field.type == Type::kFloat) {
+                s.*field.f = static_cast<float>(std::clamp(static_cast<double>(s.*field.f), field.min, field.max));
+            }
+            else if (field.type == Type::kInt) {
+                s.*field.i = static_cast<std::int32_t>(std::clamp(static_cast<double>(s.*field.i), field.min, field.max));
+            }
+        }
+
+        s.adaptiveMinRetries = std::clamp(s.adaptiveMinRetries, 1, std::max(1, s.shoveRetries));
+        s.adaptiveMaxInitialDelayFrames = std::max(s.adaptiveMaxInitialDelayFrames, s.shoveInitialDelayFrames);
+    }
+
+    std::string FormatMcm(const Settings& s)
+    {
+        std::string out;
+        std::string_view section{};
+        char line[160];
+
+        for (const auto& field : kFields) {
+            if (!field.mcm) {
+                continue;
+            }
+            if (field.section != section) {
+                out += section.empty() ? "[" : "\n[";
+                out += field.section;
+                out += "]\n";
+                section = field.section;
+            }
+
+            int n = 0;
+            const auto key = static_cast<int>(field.key.size());
+            const char letter = TypeLetter(field.type);
+            switch (field.type) {
+            case Type::kFloat:
+                n = std::snprintf(line, sizeof(line), "%c%.*s = %f\n", letter, key, field.key.data(), static_cast<double>(s.*field.f));
+                break;
+            case Type::kInt:
+                n = std::snprintf(line, sizeof(line), "%c%.*s = %d\n", letter, key, field.key.data(), s.*field.i);
+                break;
+            case Type::kBool:
+                n = std::snprintf(line, sizeof(line), "%c%.*s = %s\n", letter, key, field.key.data(), s.*field.b ? "true" : "false");
+                break;
+            }
+            out.append(line, static_cast<std::size_t>(std::max(n, 0)));
+        }
+        return out;
+    }
+}
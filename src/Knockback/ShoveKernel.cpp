@@ -0,0 +1,249 @@
+#include <Knockback/ShoveKernel.h>
+
+#include <Knockback/Physics.h>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define KNOCKBACK_KERNEL_AVX 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define KNOCKBACK_KERNEL_SSE 1
+#endif
+
+namespace Knockback
+{
+    // Below this squared length the direction is undefined (actors on top of each other).
+    constexpr float kMinDirLengthSq = 1e-6f;
+    // Separation pushes shorter than this fall back to the velocity cap.
+    constexpr float kMinSeparationDuration = 1e-4f;
+
+    void ShoveBatch::clear()
+    {
+        for (auto* v : { &aggressorX, &aggressorY, &targetX, &targetY, &baseMagnitude, &baseDuration,
+                 &minVelocity, &minDurationScale, &separation, &separationMinDistance, &separationMaxVelocity }) {
+            v->clear();
+        }
+    }
+
+    std::size_t ShoveBatch::AddShove(const Vec3& aggressor, const Vec3& target, const Settings& cfg, float weaponMult)
+    {
+        const auto lane = size();
+        aggressorX.push_back(aggressor.x);
+        aggressorY.push_back(aggressor.y);
+        targetX.push_back(target.x);
+        targetY.push_back(target.y);
+        baseMagnitude.push_back(cfg.shoveMagnitude * weaponMult);
+        baseDuration.push_back(cfg.shoveDuration);
+        minVelocity.push_back(cfg.applyCurrentMinVelocity);
+        minDurationScale.push_back(cfg.minDurationScale);
+        separation.push_back(0.0f);
+        separationMinDistance.push_back(0.0f);
+        separationMaxVelocity.push_back(0.0f);
+        return lane;
+    }
+
+    std::size_t ShoveBatch::AddSeparation(const Vec3& aggressor, const Vec3& target, const Settings& cfg)
+    {
+        const auto lane = size();
+        aggressorX.push_back(aggressor.x);
+        aggressorY.push_back(aggressor.y);
+        targetX.push_back(target.x);
+        targetY.push_back(target.y);
+        baseMagnitude.push_back(0.0f);
+        baseDuration.push_back(cfg.separationPushDuration);
+        minVelocity.push_back(cfg.applyCurrentMinVelocity);
+        minDurationScale.push_back(cfg.minDurationScale);
+        separation.push_back(1.0f);
+        separationMinDistance.push_back(cfg.minSeparationDistance);
+        separationMaxVelocity.push_back(cfg.separationMaxVelocity);
+        return lane;
+    }
+
+    static void ResizeOutputs(ShoveBatch& b)
+    {
+        const auto n = b.size();
+        b.distance.resize(n);
+        b.dirX.resize(n);
+        b.dirY.resize(n);
+        b.magnitude.resize(n);
+        b.duration.resize(n);
+    }
+
+    static void ComputeLanesScalar(ShoveBatch& b, std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i) {
+            const Vec3 a{ b.aggressorX[i], b.aggressorY[i], 0.0f };
+            const Vec3 t{ b.targetX[i], b.targetY[i], 0.0f };
+
+            const float dx = t.x - a.x;
+            const float dy = t.y - a.y;
+            const float lenSq = dx * dx + dy * dy;
+            const float dist = HorizontalDistance(a, t);
+
+            b.distance[i] = dist;
+            if (lenSq < kMinDirLengthSq) {
+                b.dirX[i] = 0.0f;
+                b.dirY[i] = 0.0f;
+            }
+            else {
+                const float invLen = 1.0f / dist;
+                b.dirX[i] = dx * invLen;
+                b.dirY[i] = dy * invLen;
+            }
+
+            float dur = b.baseDuration[i];
+            float mag = b.baseMagnitude[i];
+            if (b.separation[i] != 0.0f) {
+                const float maxVel = b.separationMaxVelocity[i];
+                const float deficit = b.separationMinDistance[i] - dist;
+                mag = (dur > kMinSeparationDuration) ? (deficit / dur) : maxVel;
+                if (maxVel > 0.0f) {
+                    mag = std::min(mag, maxVel);
+                }
+            }
+
+            Settings shape{};
+            shape.applyCurrentMinVelocity = b.minVelocity[i];
+            shape.minDurationScale = b.minDurationScale[i];
+            ShapeForApplyCurrent(shape, mag, dur);
+
+            b.magnitude[i] = mag;
+            b.duration[i] = dur;
+        }
+    }
+
+    void ComputeShoveGeometryScalar(ShoveBatch& batch)
+    {
+        ResizeOutputs(batch);
+        ComputeLanesScalar(batch, 0, batch.size());
+    }
+
+#if defined(KNOCKBACK_KERNEL_SSE) || defined(KNOCKBACK_KERNEL_AVX)
+    // Same sequence of IEEE ops as ComputeLanesScalar (sqrt/div are exact), so the two
+    // paths agree bit for bit unless the compiler contracts the scalar side into FMAs.
+    template <class Ops>
+    static std::size_t ComputeLanesWide(ShoveBatch& b)
+    {
+        using V = typename Ops::V;
+
+        const V zero = Ops::Set(0.0f);
+        const V one = Ops::Set(1.0f);
+        const V minLenSq = Ops::Set(kMinDirLengthSq);
+        const V minSepDur = Ops::Set(kMinSeparationDuration);
+
+        const auto n = b.size() - b.size() % Ops::kLanes;
+        for (std::size_t i = 0; i < n; i += Ops::kLanes) {
+            const V dx = Ops::Sub(Ops::Load(&b.targetX[i]), Ops::Load(&b.aggressorX[i]));
+            const V dy = Ops::Sub(Ops::Load(&b.targetY[i]), Ops::Load(&b.aggressorY[i]));
+            const V lenSq = Ops::Add(Ops::Mul(dx, dx), Ops::Mul(dy, dy));
+            const V dist = Ops::Sqrt(lenSq);
+
+            const V hasDir = Ops::CmpGe(lenSq, minLenSq);
+            const V invLen = Ops::Div(one, dist);
+            Ops::Store(&b.distance[i], dist);
+            Ops::Store(&b.dirX[i], Ops::Select(hasDir, Ops::Mul(dx, invLen), zero));
+            Ops::Store(&b.dirY[i], Ops::Select(hasDir, Ops::Mul(dy, invLen), zero));
+
+            V dur = Ops::Load(&b.baseDuration[i]);
+            V mag = Ops::Load(&b.baseMagnitude[i]);
+
+            // Separation lanes: deficit / duration, capped by the max velocity when set.
+            const V maxVel = Ops::Load(&b.separationMaxVelocity[i]);
+            const V deficit = Ops::Sub(Ops::Load(&b.separationMinDistance[i]), dist);
+            V sepMag = Ops::Select(Ops::CmpGt(dur, minSepDur), Ops::Div(deficit, dur), maxVel);
+            sepMag = Ops::Select(Ops::CmpGt(maxVel, zero), Ops::Min(sepMag, maxVel), sepMag);
+            mag = Ops::Select(Ops::CmpNeq(Ops::Load(&b.separation[i]), zero), sepMag, mag);
+
+            // ShapeForApplyCurrent
+            const V minVel = Ops::Load(&b.minVelocity[i]);
+            const V shaped = Ops::And(Ops::CmpGt(minVel, zero), Ops::CmpGt(mag, zero));
+            const V peak = Ops::Max(mag, minVel);
+            const V scaled = Ops::Mul(dur, Ops::Div(mag, peak));
+            const V minDur = Ops::Mul(dur, Ops::Load(&b.minDurationScale[i]));
+            mag = Ops::Select(shaped, peak, mag);
+            dur = Ops::Select(shaped, Ops::Max(scaled, minDur), dur);
+
+            Ops::Store(&b.magnitude[i], mag);
+            Ops::Store(&b.duration[i], dur);
+        }
+        return n;
+    }
+#endif
+
+#if defined(KNOCKBACK_KERNEL_SSE)
+    struct SseOps
+    {
+        using V = __m128;
+        static constexpr std::size_t kLanes = 4;
+
+        static V Set(float v) { return _mm_set1_ps(v); }
+        static V Load(const float* p) { return _mm_loadu_ps(p); }
+        static void Store(float* p, V v) { _mm_storeu_ps(p, v); }
+        static V Add(V a, V b) { return _mm_add_ps(a, b); }
+        static V Sub(V a, V b) { return _mm_sub_ps(a, b); }
+        static V Mul(V a, V b) { return _mm_mul_ps(a, b); }
+        static V Div(V a, V b) { return _mm_div_ps(a, b); }
+        static V Sqrt(V a) { return _mm_sqrt_ps(a); }
+        // Operand order matches std::min/std::max for non-NaN inputs.
+        static V Min(V a, V b) { return _mm_min_ps(b, a); }
+        static V Max(V a, V b) { return _mm_max_ps(b, a); }
+        static V And(V a, V b) { return _mm_and_ps(a, b); }
+        static V CmpGt(V a, V b) { return _mm_cmpgt_ps(a, b); }
+        static V CmpGe(V a, V b) { return _mm_cmpge_ps(a, b); }
+        static V CmpNeq(V a, V b) { return _mm_cmpneq_ps(a, b); }
+        static V Select(V mask, V a, V b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+    };
+#endif
+
+#if defined(KNOCKBACK_KERNEL_AVX)
+    struct AvxOps
+    {
+        using V = __m256;
+        static constexpr std::size_t kLanes = 8;
+
+        static V Set(float v) { return _mm256_set1_ps(v); }
+        static V Load(const float* p) { return _mm256_loadu_ps(p); }
+        static void Store(float* p, V v) { _mm256_storeu_ps(p, v); }
+        static V Add(V a, V b) { return _mm256_add_ps(a, b); }
+        static V Sub(V a, V b) { return _mm256_sub_ps(a, b); }
+        static V Mul(V a, V b) { return _mm256_mul_ps(a, b); }
+        static V Div(V a, V b) { return _mm256_div_ps(a, b); }
+        static V Sqrt(V a) { return _mm256_sqrt_ps(a); }
+        static V Min(V a, V b) { return _mm256_min_ps(b, a); }
+        static V Max(V a, V b) { return _mm256_max_ps(b, a); }
+        static V And(V a, V b) { return _mm256_and_ps(a, b); }
+        static V CmpGt(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+        static V CmpGe(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+        static V CmpNeq(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_NEQ_UQ); }
+        static V Select(V mask, V a, V b) { return _mm256_blendv_ps(b, a, mask); }
+    };
+#endif
+
+    void ComputeShoveGeometry(ShoveBatch& batch)
+    {
+        ResizeOutputs(batch);
+
+        std::size_t done = 0;
+#if defined(KNOCKBACK_KERNEL_AVX)
+        done = ComputeLanesWide<AvxOps>(batch);
+#elif defined(KNOCKBACK_KERNEL_SSE)
+        done = ComputeLanesWide<SseOps>(batch);
+#endif
+        ComputeLanesScalar(batch, done, batch.size());
+    }
+
+    std::size_t ShoveKernelLanes()
+    {
+#if defined(KNOCKBACK_KERNEL_AVX)
+        return AvxOps::kLanes;
+#elif defined(KNOCKBACK_KERNEL_SSE)
+        return SseOps::kLanes;
+#else
+        return 1;
+#endif
+    }
+}
@@ -1,301 +1,799 @@
 #include <Knockback/Tasks.h>
 
-#include <Knockback/Config.h>
-#include <Knockback/Filters.h>
+#include <Knockback/Adaptive.h>
+#include <Knockback/AttackTracker.h>
+#include <Knockback/BinLog.h>
+#include <Knockback/Budget.h>
+#include <Knockback/HitPipeline.h>
+#include <Knockback/Lod.h>
+#include <Knockback/Metrics.h>
 #include <Knockback/Physics.h>
+#include <Knockback/Registry.h>
+#include <Knockback/Separation.h>
+#include <Knockback/ShoveKernel.h>
 
-#include "SKSE/SKSE.h"
 #include <algorithm>
+#include <array>
 #include <cmath>
-
-namespace logger = SKSE::log;
+#include <utility>
+#include <vector>
 
 namespace Knockback
 {
+    // Cap on how long a hit waits for the target to finish its own attack.
+    constexpr std::int32_t kAttackDeferralMaxFrames = 20;
+    // Camera distance bands for budget ranking; within a band the fresher hit goes first.
+    constexpr float kRankBandUnits = 256.0f;
+
+    struct JobActors
+    {
+        ActorState aggressor;
+        ActorState target;
+    };
+
+    // Victims of one attack come due together; their aggressor is read once per tick, not once
+    // per victim. Reset at the start of every tick (positions only change between frames).
+    struct AggressorMemo
+    {
+        ActorId id{ 0 };
+        bool resolved{ false };
+        ActorState state;
+        const Settings* cfg{ nullptr };
+        std::int8_t firstPerson{ -1 };   // -1: not asked yet for cfg
+    };
+
+    static AggressorMemo g_aggressorMemo{};
+
+    static bool ResolveAggressor(const IWorld& world, ActorId id, ActorState& out)
+    {
+        auto& memo = g_aggressorMemo;
+        if (memo.id == id) {
+            out = memo.state;
+            return memo.resolved;
+        }
+
+        memo.id = id;
+        memo.resolved = world.GetActorState(id, out);
+        memo.state = out;
+        memo.firstPerson = -1;
+        return memo.resolved;
+    }
+
+    // Both ends still resolve, are distinct, and are alive.
+    static bool ResolveJobActors(const IWorld& world, const Job& job, JobActors& out)
+    {
+        if (job.aggressor == job.target) return false;
+        if (!ResolveAggressor(world, job.aggressor, out.aggressor)) return false;
+        if (!world.GetActorState(job.target, out.target)) return false;
+        return !out.aggressor.dead && !out.target.dead;
+    }
+
+    static bool SuppressedByFirstPerson(const IWorld& world, const Settings& cfg, const Job& job, const JobActors& actors)
+    {
+        if (!cfg.disableInFirstPerson || !actors.aggressor.player) {
+            return false;
+        }
+
+        auto& memo = g_aggressorMemo;
+        if (memo.id != job.aggressor) {
+            return world.SuppressedByFirstPerson(cfg, job.aggressor);
+        }
+        if (memo.cfg != &cfg || memo.firstPerson < 0) {
+            memo.cfg = &cfg;
+            memo.firstPerson = world.SuppressedByFirstPerson(cfg, job.aggressor) ? 1 : 0;
+        }
+        return memo.firstPerson != 0;
+    }
+
+    // Every scheduled job holds a reference on its target's chain until it has run.
+    static void ScheduleChainJob(const Job& job, std::int32_t delayFrames)
+    {
+        RetainShoveChain(job.target);
+        ScheduleJob(job, delayFrames);
+    }
+
+    static Adaptive::Key AdaptiveKey(const JobActors& actors)
+    {
+        return { actors.target.race, actors.aggressor.player };
+    }
+
     static void QueueShoveEffectivenessCheck(
-        RE::ActorHandle aggressorH,
-        RE::ActorHandle targetH,
+        const Job& from,
         std::int32_t remainingTries,
         float distBefore,
         std::int32_t delayFrames,
-        float weaponMult)
+        std::int32_t reapplies)
     {
-        auto taskIf = SKSE::GetTaskInterface();
-        if (!taskIf) {
-            return;
-        }
+        Job job = from;
+        job.kind = JobKind::kEffectivenessCheck;
+        job.tries = remainingTries;
+        job.distance = distBefore;
+        job.counter = reapplies;
+        job.deferrals = 0;
+        ScheduleChainJob(job, delayFrames);
+    }
 
-        taskIf->AddTask([=]() {
-            if (delayFrames > 0) {
-                QueueShoveEffectivenessCheck(
-                    aggressorH, targetH, remainingTries, distBefore, delayFrames - 1, weaponMult);
-                return;
-            }
+    static void QueuePhysicsShove(const Job& from, std::int32_t remainingTries, std::int32_t delayFrames, std::int32_t attempt)
+    {
+        Job job = from;
+        job.kind = JobKind::kShove;
+        job.tries = remainingTries;
+        job.distance = -1.0f;
+        job.counter = attempt;
+        job.deferrals = 0;
+        ScheduleChainJob(job, delayFrames);
+    }
 
-            auto aggressorPtr = aggressorH.get();
-            auto targetPtr = targetH.get();
-            RE::Actor* aggressor = aggressorPtr ? aggressorPtr.get() : nullptr;
-            RE::Actor* target = targetPtr ? targetPtr.get() : nullptr;
+    // A due shove/effectiveness job that passed its gates. Its geometry is
+    // lane `lane` of the tick's batch; the chain reference is held until it has run.
+    struct PreparedJob
+    {
+        Job job;
+        const Settings* cfg{ nullptr };
+        JobActors actors;
+        std::size_t lane{ 0 };
+        std::uint64_t chainStartFrame{ 0 };
+        std::uint64_t hitMicros{ 0 };
+        std::uint64_t rank{ 0 };   // lower runs first when the frame budget is on
+        std::size_t order{ 0 };    // due order, breaks rank ties
+    };
+
+    struct Geometry
+    {
+        float distance{ 0.0f };
+        float dirX{ 0.0f };
+        float dirY{ 0.0f };
+        float magnitude{ 0.0f };
+        float duration{ 0.0f };
+    };
+
+    // Main-thread only (scheduler tick); capacity is reused from frame to frame.
+    static ShoveBatch g_batch{};
+    static std::vector<PreparedJob> g_prepared{};
+    static std::vector<Job> g_woken{};
+
+    static Geometry LaneGeometry(const ShoveBatch& b, std::size_t lane)
+    {
+        return { b.distance[lane], b.dirX[lane], b.dirY[lane], b.magnitude[lane], b.duration[lane] };
+    }
 
-            if (!aggressor || !target) return;
-            if (aggressor == target) return;
-            if (aggressor->IsDead() || target->IsDead()) return;
+    // Everything a geometric job checks before any math is done.
+    static bool PassesGates(IWorld& world, const Settings& cfg, const Job& job, JobActors& actors)
+    {
+        if (!ResolveJobActors(world, job, actors)) return false;
 
-            if (ShouldDisableDueToFirstPerson(aggressor)) return;
-            if (!IsValidKnockbackTarget(target)) return;
+        if (SuppressedByFirstPerson(world, cfg, job, actors)) {
+            if (job.kind == JobKind::kShove) {
+                KB_TRACE("Shove (queued): suppressed (player in first-person)");
+            }
+            return false;
+        }
 
-            if (weaponMult <= 0.0f) {
-                return;
+        if (!world.IsValidTarget(cfg, job.target)) return false;
+
+        // INI is authoritative: multiplier <= 0 means no shove
+        if (job.weaponMult <= 0.0f) {
+            if (job.kind == JobKind::kShove) {
+                KB_TRACE("Shove (queued): suppressed (weapon not configured)");
             }
+            return false;
+        }
+        return true;
+    }
+
+    static void RunShoveEffectivenessCheck(IWorld& world, const PreparedJob& p, const Geometry& g)
+    {
+        const auto& cfg = *p.cfg;
+        const auto& job = p.job;
+        const float distBefore = job.distance;
+        const float distAfter = g.distance;
+        const float gained = distAfter - distBefore;
+        const bool effective = gained >= cfg.minShoveSeparationDelta;
+        Adaptive::RecordEffect(AdaptiveKey(p.actors), job.counter, effective);
+
+        if (effective) {
+            Metrics::Add(Metrics::Counter::kEffectOk);
+            KB_TRACE(
+                "ShoveEffect: ok before={} after={} gained={}",
+                distBefore, distAfter, gained);
+            return;
+        }
 
-            const auto& cfg = GetConfig();
+        const auto nextTries = job.tries - 1;
+        if (nextTries <= 0) {
+            Metrics::Add(Metrics::Counter::kEffectExhausted);
+            return;
+        }
 
-            const float distAfter = HorizontalDistance(aggressor, target);
-            const float gained = distAfter - distBefore;
+        const bool ok = ApplyPhysicsShove(world, job.target, g.dirX, g.dirY, g.magnitude, g.duration);
+        Metrics::Add(ok ? Metrics::Counter::kEffectReapply : Metrics::Counter::kEffectReapplyFailed);
+        KB_TRACE(
+            "ShoveEffect: reapply ok={} mag={} dur={} mult={}",
+            ok, g.magnitude, g.duration, job.weaponMult);
 
-            if (gained >= cfg.minShoveSeparationDelta) {
-                logger::trace(
-                    "ShoveEffect: ok before={} after={} gained={}",
-                    distBefore, distAfter, gained);
-                return;
+        QueueShoveEffectivenessCheck(job, nextTries, distAfter, std::max(1, cfg.shoveRetryDelayFrames), job.counter + 1);
+    }
+
+    static void RunPhysicsShove(IWorld& world, const PreparedJob& p, const Geometry& g, std::uint64_t tickMicros)
+    {
+        const auto& cfg = *p.cfg;
+        const auto& job = p.job;
+        const float distBefore = g.distance;
+        const bool ok = ApplyPhysicsShove(world, job.target, g.dirX, g.dirY, g.magnitude, g.duration);
+        const auto key = AdaptiveKey(p.actors);
+        Adaptive::RecordShove(key, job.counter, ok);
+
+        if (ok) {
+            // Only the first success of a chain gets here: later shove jobs are retries of failures.
+            Metrics::Add(Metrics::Counter::kShoveApplied);
+            Metrics::Record(Metrics::Histogram::kHitToImpulseFrames, GetSchedulerFrame() - p.chainStartFrame);
+            Metrics::Record(Metrics::Histogram::kHitToImpulseMicros, tickMicros - std::min(tickMicros, p.hitMicros));
+            Metrics::Record(Metrics::Histogram::kShoveAttempts, static_cast<std::uint64_t>(std::max(1, job.counter)));
+
+            KB_TRACE(
+                "Shove (queued): applied mag={} dur={} mult={} triesLeftAfter={}",
+                g.magnitude, g.duration, job.weaponMult, job.tries - 1);
+
+            // From here on a new hit supersedes this chain instead of merging into it.
+            MarkShoveApplied(job.target, job.generation);
+
+            if (cfg.minShoveSeparationDelta > 0.0f) {
+                if (job.lod != Lod::Tier::kNear) {
+                    Metrics::Add(Metrics::Counter::kLodEffectSkipped);
+                }
+                else if (!Budget::Allows(Budget::Level::kNoEffectiveness)) {
+                    Metrics::Add(Metrics::Counter::kDegradeSkipped);
+                }
+                else if (const auto checks = Adaptive::EffectTries(cfg, key, job.tries, job.counter); checks > 0) {
+                    QueueShoveEffectivenessCheck(job, checks, distBefore, /*delayFrames*/ 1, /*reapplies*/ 0);
+                }
             }
 
-            const auto nextTries = remainingTries - 1;
-            if (nextTries <= 0) {
-                return;
+            if (cfg.enforceMinSeparation && cfg.separationRetries > 0 && p.actors.aggressor.player) {
+                if (!Budget::Allows(Budget::Level::kNoSeparation)) {
+                    Metrics::Add(Metrics::Counter::kDegradeSkipped);
+                }
+                else {
+                    // The pair outlives the chain; it keeps the chain's snapshot alive itself.
+                    Separation::Engage(GetShoveChainSettings(job.target, job.generation), job.aggressor, job.target, GetSchedulerFrame());
+                }
             }
+            return;
+        }
 
-            float mag = cfg.shoveMagnitude * weaponMult;
-            float dur = cfg.shoveDuration;
-            ShapeForApplyCurrent(mag, dur);
-
-            const bool ok = ApplyPhysicsShove(aggressor, target, mag, dur);
-            logger::trace(
-                "ShoveEffect: reapply ok={} mag={} dur={} mult={}",
-                ok, mag, dur, weaponMult);
-
-            QueueShoveEffectivenessCheck(
-                aggressorH,
-                targetH,
-                nextTries,
-                distAfter,
-                std::max(1, cfg.shoveRetryDelayFrames),
-                weaponMult);
-            });
-    }
+        KB_TRACE(
+            "Shove (queued): failed mag={} dur={} mult={} triesLeftAfter={}",
+            g.magnitude, g.duration, job.weaponMult, job.tries - 1);
+        Metrics::Add(Metrics::Counter::kShoveFailed);
 
+        const auto nextTries = job.tries - 1;
+        if (nextTries > 0) {
+            Metrics::Add(Metrics::Counter::kShoveRetry);
+            QueuePhysicsShove(job, nextTries, cfg.shoveRetryDelayFrames, job.counter + 1);
+        }
+        else {
+            Metrics::Add(Metrics::Counter::kShoveExhausted);
+        }
+    }
 
-    void QueueEnforceMinSeparation(RE::ActorHandle aggressorH,
-        RE::ActorHandle targetH,
-        std::int32_t remainingTries,
-        std::int32_t delayFrames,
-        float lastDist,
-        std::int32_t noProgressCount)
+    static void RunAttackDeferral(IWorld& world, const ShoveChain& chain, const Job& job)
     {
-        const auto& cfg = GetConfig();
-
-        if (!cfg.enforceMinSeparation || cfg.minSeparationDistance <= 0.0f || remainingTries <= 0) {
+        const Settings& cfg = *chain.cfg;
+
+        ActorState aggressor{};
+        ActorState target{};
+        if (!ResolveAggressor(world, job.aggressor, aggressor) || !world.GetActorState(job.target, target)) return;
+
+        // If still attacking, keep deferring until we hit the cap: parked until the attack-end
+        // event where the target is watched, polled every frame where it is not.
+        const auto frame = GetSchedulerFrame();
+        const auto state = job.counter > 0 ? Attacks::Query(world, job.target, frame) : Attacks::State::kIdle;
+        if (state == Attacks::State::kAttacking) {
+            RetainShoveChain(job.target);
+            Attacks::Park(job, frame + static_cast<std::uint64_t>(job.counter));
+            KB_TRACE("Actor attacking. Parked until attack end or {} frames", job.counter);
             return;
         }
-
-        auto taskIf = SKSE::GetTaskInterface();
-        if (!taskIf) {
-            logger::trace("Separation: no TaskInterface");
+        if (state == Attacks::State::kUnwatched && world.IsAttacking(job.target)) {
+            constexpr std::int32_t poll = 1;
+            Job next = job;
+            next.counter -= poll;
+            ScheduleChainJob(next, 0);
+
+            Metrics::Add(Metrics::Counter::kDeferralPoll);
+            KB_TRACE("Actor attacking. Deferring...");
             return;
         }
 
-        taskIf->AddTask([aggressorH, targetH, remainingTries, delayFrames, lastDist, noProgressCount]() mutable {
-            const auto& cfg = GetConfig();
+        Metrics::Record(Metrics::Histogram::kDeferralFrames, frame - chain.startFrame);
+        QueuePhysicsShove(job, job.tries, Adaptive::InitialDelayFrames(cfg, { target.race, aggressor.player }), /*attempt*/ 1);
+    }
 
-            if (delayFrames > 0) {
-                QueueEnforceMinSeparation(aggressorH, targetH, remainingTries, delayFrames - 1, lastDist, noProgressCount);
-                return;
+    // Tight frames spend the budget on what the player notices: their own fights first, then
+    // whatever is closest to the camera, then the freshest hit. Equal ranks keep due order
+    // through the order tie-break; std::stable_sort would allocate a buffer every tick.
+    static void RankPrepared(const IWorld& world, std::uint64_t tickMicros)
+    {
+        Vec3 camera{};
+        const bool haveCamera = world.GetCameraPosition(camera);
+
+        constexpr std::uint64_t kAgeMask = (std::uint64_t{ 1 } << 40) - 1;
+        for (std::size_t i = 0; i < g_prepared.size(); ++i) {
+            auto& p = g_prepared[i];
+            p.order = i;
+            const bool player = p.actors.aggressor.player || p.actors.target.player;
+            std::uint64_t band = 0;
+            if (haveCamera) {
+                band = static_cast<std::uint64_t>(std::min(HorizontalDistance(camera, p.actors.target.position) / kRankBandUnits, 255.0f));
             }
+            const auto age = std::min(tickMicros - std::min(tickMicros, p.hitMicros), kAgeMask);
+            p.rank = (player ? 0 : std::uint64_t{ 1 } << 48) | (band << 40) | age;
+        }
 
-            auto aggressorPtr = aggressorH.get();
-            auto targetPtr = targetH.get();
-            RE::Actor* aggressor = aggressorPtr ? aggressorPtr.get() : nullptr;
-            RE::Actor* target = targetPtr ? targetPtr.get() : nullptr;
+        std::sort(g_prepared.begin(), g_prepared.end(), [](const PreparedJob& a, const PreparedJob& b) {
+            return a.rank != b.rank ? a.rank < b.rank : a.order < b.order;
+        });
+    }
 
-            if (!aggressor || !target) return;
-            if (aggressor == target) return;
-            if (aggressor->IsDead() || target->IsDead()) return;
+    // No room left this frame: a shove waits for the next one (a few times at most); an
+    // effectiveness check only confirms a shove that already happened and is dropped.
+    static void PutOffOverBudget(const PreparedJob& p)
+    {
+        if (p.job.kind == JobKind::kShove && p.job.deferrals < Budget::kMaxDeferrals) {
+            Job next = p.job;
+            ++next.deferrals;
+            ScheduleChainJob(next, 0);
+            Metrics::Add(Metrics::Counter::kBudgetDeferred);
+            KB_TRACE("Shove (queued): over frame budget, deferred ({})", next.deferrals);
+        }
+        else {
+            Metrics::Add(Metrics::Counter::kBudgetDropped);
+        }
+    }
 
-            // Separation is only for player aggressor
-            if (!IsPlayer(aggressor)) {
-                return;
+    // tickMicros stands in for "now" for the whole tick; one clock read instead of one per job.
+    // budget is the current snapshot (frame budgets apply to the frame, not to a chain).
+    // Returns how many jobs did not fit the budget.
+    static std::size_t RunJobsBatched(const Settings& budget, const std::vector<Job>& due, std::uint64_t tickMicros)
+    {
+        auto& world = GetWorld();
+
+        g_batch.clear();
+        g_prepared.clear();
+
+        // Pass 1: drop stale jobs, run deferrals, gate the rest and gather their geometry.
+        for (const auto& job : due) {
+            ShoveChain chain{};
+            if (!LookupShoveChain(job.target, job.generation, chain)) {
+                // A newer hit took over this target; drop the stale step.
+                Metrics::Add(Metrics::Counter::kJobStale);
+                ReleaseShoveChain(job.target);
+                continue;
             }
 
-            if (ShouldDisableDueToFirstPerson(aggressor)) return;
-            if (!IsValidKnockbackTarget(target)) return;
+            // Hits that merged into a pending chain may have changed who shoves and how hard.
+            Job current = job;
+            current.aggressor = chain.aggressor;
+            current.weaponMult = chain.weaponMult;
 
-            const float dist = HorizontalDistance(aggressor, target);
-            const float minDist = cfg.minSeparationDistance;
+            // The whole chain runs against the snapshot it started with, even across a reload.
+            const Settings& cfg = *chain.cfg;
 
-            if (lastDist >= 0.0f) {
-                const float delta = std::fabs(dist - lastDist);
+            if (current.kind == JobKind::kAttackDeferral) {
+                RunAttackDeferral(world, chain, current);
+                ReleaseShoveChain(job.target);
+                continue;
+            }
 
-                if (delta < 1.0f) {
-                    noProgressCount++;
-                }
-                else {
-                    noProgressCount = 0;
-                }
+            if (current.kind == JobKind::kEffectivenessCheck && !Budget::Allows(Budget::Level::kNoEffectiveness)) {
+                Metrics::Add(Metrics::Counter::kDegradeSkipped);
+                ReleaseShoveChain(job.target);
+                continue;
+            }
 
-                if (noProgressCount >= 2) {
-                    logger::trace("Separation: no progress (dist={} lastDist={} delta={}) -> stop",
-                        dist, lastDist, delta);
-                    return;
-                }
+            PreparedJob prepared{};
+            prepared.job = current;
+            prepared.cfg = &cfg;
+            prepared.chainStartFrame = chain.startFrame;
+            prepared.hitMicros = chain.hitMicros;
+            if (!PassesGates(world, cfg, current, prepared.actors)) {
+                Metrics::Add(Metrics::Counter::kJobGated);
+                ReleaseShoveChain(job.target);
+                continue;
             }
 
-            if (dist >= minDist) {
-                logger::trace("Separation: ok dist={} (min={})", dist, minDist);
-                return;
+            const auto& a = prepared.actors;
+            if (current.kind == JobKind::kShove && !a.aggressor.player && !a.target.player &&
+                !Budget::Allows(Budget::Level::kPlayerOnly)) {
+                Metrics::Add(Metrics::Counter::kDegradeSkipped);
+                ReleaseShoveChain(job.target);
+                continue;
             }
 
-            const float deficit = (minDist - dist);
+            prepared.lane = g_batch.AddShove(a.aggressor.position, a.target.position, cfg, current.weaponMult);
+            g_prepared.push_back(prepared);
+        }
 
-            float dur = cfg.separationPushDuration;
-            float mag = (dur > 1e-4f) ? (deficit / dur) : cfg.separationMaxVelocity;
+        if (g_prepared.empty()) {
+            return 0;
+        }
 
-            if (cfg.separationMaxVelocity > 0.0f) {
-                mag = std::min(mag, cfg.separationMaxVelocity);
+        // Pass 2: one vectorized sweep for distances, directions and shaped velocity/duration.
+        ComputeShoveGeometry(g_batch);
+
+        // Pass 3: decisions and ApplyCurrent, in due order, or by rank while a budget is set.
+        // The first job always runs, so a budget can slow the queue down but never stall it.
+        std::size_t allowed = g_prepared.size();
+        const auto budgetMicros = static_cast<std::uint64_t>(std::max(0, budget.frameBudgetMicros));
+        if (Budget::Enabled(budget)) {
+            RankPrepared(world, tickMicros);
+            if (budget.frameBudgetJobs > 0) {
+                allowed = std::min(allowed, static_cast<std::size_t>(budget.frameBudgetJobs));
             }
+        }
 
-            ShapeForApplyCurrent(mag, dur);
+        std::size_t overBudget = 0;
+        for (std::size_t i = 0; i < g_prepared.size(); ++i) {
+            const auto& p = g_prepared[i];
+            if (i > 0 && i < allowed && budgetMicros > 0 && Metrics::NowMicros() - tickMicros >= budgetMicros) {
+                allowed = i;
+            }
+            if (i >= allowed) {
+                PutOffOverBudget(p);
+                ++overBudget;
+                ReleaseShoveChain(p.job.target);
+                continue;
+            }
 
-            const bool ok = ApplyVelocityAwayFrom(/*from=*/target, /*who=*/aggressor, mag, dur);
+            const auto g = LaneGeometry(g_batch, p.lane);
+
+            switch (p.job.kind) {
+            case JobKind::kShove:
+                RunPhysicsShove(world, p, g, tickMicros);
+                break;
+            case JobKind::kEffectivenessCheck:
+                RunShoveEffectivenessCheck(world, p, g);
+                break;
+            case JobKind::kAttackDeferral:
+                break;
+            }
 
-            logger::trace("Separation: dist={} deficit={} -> pushAggressor mag={} dur={} ok={} triesLeftAfter={}",
-                dist, deficit, mag, dur, ok, remainingTries - 1);
+            ReleaseShoveChain(p.job.target);
+        }
+        return overBudget;
+    }
 
-            const auto nextTries = remainingTries - 1;
-            if (nextTries > 0) {
-                QueueEnforceMinSeparation(aggressorH, targetH, nextTries, cfg.separationRetryDelayFrames, dist, noProgressCount);
+    // Parked deferrals whose target stopped attacking (or that waited long enough) go on to
+    // their shove; counter 0 keeps them from waiting again.
+    static void RunWokenDeferrals(IWorld& world)
+    {
+        for (const auto& job : g_woken) {
+            ShoveChain chain{};
+            if (!LookupShoveChain(job.target, job.generation, chain)) {
+                Metrics::Add(Metrics::Counter::kJobStale);
+                ReleaseShoveChain(job.target);
+                continue;
             }
-            });
+
+            Job current = job;
+            current.aggressor = chain.aggressor;
+            current.weaponMult = chain.weaponMult;
+            current.counter = 0;
+            RunAttackDeferral(world, chain, current);
+            ReleaseShoveChain(job.target);
+        }
     }
 
-    void QueuePhysicsShove(
-        RE::ActorHandle aggressorH,
-        RE::ActorHandle targetH,
-        std::int32_t remainingTries,
-        std::int32_t delayFrames,
-        float weaponMult)
+    void RunJobs(const std::vector<Job>& due)
+    {
+        auto& world = GetWorld();
+        const auto start = Metrics::NowMicros();
+        const auto cfg = world.AcquireSettings();
+
+        // Once per tick, before anything resolves an aggressor: woken deferrals do too.
+        g_aggressorMemo = AggressorMemo{};
+
+        g_woken.clear();
+        Attacks::BeginTick(world, GetSchedulerFrame(), g_woken);
+        RunWokenDeferrals(world);
+
+        const auto overBudget = RunJobsBatched(*cfg, due, start);
+
+        if (Budget::Allows(Budget::Level::kNoSeparation)) {
+            // Pairs engaged this tick are due next frame at the earliest.
+            Separation::Update(world, GetSchedulerFrame());
+        }
+        else if (const auto dropped = Separation::Clear(); dropped > 0) {
+            Metrics::Add(Metrics::Counter::kDegradeSkipped, dropped);
+        }
+
+        const auto micros = Metrics::NowMicros() - start;
+        Budget::EndTick(*cfg, micros, overBudget);
+        Metrics::Record(Metrics::Histogram::kTickJobs, due.size());
+        Metrics::Record(Metrics::Histogram::kTickMicros, micros);
+
+        const auto pool = GetJobPoolStats();
+        Metrics::Set(Metrics::Gauge::kJobsLive, pool.live);
+        Metrics::Set(Metrics::Gauge::kJobsHighWater, pool.highWater);
+        Metrics::Set(Metrics::Gauge::kJobPoolCapacity, pool.capacity);
+        Metrics::Set(Metrics::Gauge::kJobPoolChunks, pool.chunks);
+        Metrics::Set(Metrics::Gauge::kChainsLive, GetActiveShoveChainCount());
+        Metrics::Set(Metrics::Gauge::kChainsHighWater, GetShoveChainHighWater());
+        Metrics::Set(Metrics::Gauge::kSeparationPairs, Separation::ActivePairCount());
+        Metrics::Set(Metrics::Gauge::kSeparationPairsHighWater, Separation::PairHighWater());
+        Metrics::Set(Metrics::Gauge::kAdaptiveKeys, Adaptive::KeyCount());
+        Metrics::Set(Metrics::Gauge::kAttackWatched, Attacks::WatchedCount());
+        Metrics::Set(Metrics::Gauge::kDeferralsParked, Attacks::ParkedCount());
+    }
+
+    static void StartShoveChain(
+        SettingsPtr cfg,
+        ActorId aggressor,
+        ActorId target,
+        std::int32_t tries,
+        float weaponMult,
+        std::int32_t remainingWaitFrames,
+        std::uint64_t hitMicros,
+        Lod::Tier lod)
     {
-        auto taskIf = SKSE::GetTaskInterface();
-        if (!taskIf) {
-            logger::trace("Shove (queued): no TaskInterface");
+        std::uint32_t generation = 0;
+        const auto begin = BeginShoveChain(target, aggressor, weaponMult, std::move(cfg), hitMicros, generation);
+
+        if (begin == ChainBegin::kUpdated) {
+            Metrics::Add(Metrics::Counter::kChainMerged);
+            KB_TRACE("Shove: merged into pending chain gen={}", generation);
             return;
         }
+        Metrics::Add(begin == ChainBegin::kStarted ? Metrics::Counter::kChainStarted : Metrics::Counter::kChainSuperseded);
+
+        Job job{};
+        job.kind = JobKind::kAttackDeferral;
+        job.aggressor = aggressor;
+        job.target = target;
+        job.tries = tries;
+        job.weaponMult = weaponMult;
+        job.counter = remainingWaitFrames;
+        job.generation = generation;
+        job.lod = lod;
+
+        // BeginShoveChain already holds the reference for this first job.
+        ScheduleJob(job, 0);
+    }
 
-        taskIf->AddTask([=]() {
-            const auto& cfg = GetConfig();
+    void QueuePhysicsShoveWithAttackDeferral(
+        ActorId aggressor,
+        ActorId target,
+        std::int32_t tries,
+        float weaponMult,
+        std::int32_t remainingWaitFrames)
+    {
+        StartShoveChain(GetWorld().AcquireSettings(), aggressor, target, tries, weaponMult, remainingWaitFrames, Metrics::NowMicros(), Lod::Tier::kNear);
+    }
 
-            if (delayFrames > 0) {
-                QueuePhysicsShove(aggressorH, targetH, remainingTries, delayFrames - 1, weaponMult);
-                return;
-            }
+    // Camera position for one hit batch, read the first time a hit needs its LOD tier.
+    struct LodCamera
+    {
+        bool read{ false };
+        bool known{ false };
+        Vec3 position;
+    };
+
+    // Main-thread only (hit drain); one lane, reused.
+    static ShoveBatch g_impulse{};
+
+    // Far-tier impulse: one ApplyCurrent straight from the hit, with no chain and no jobs.
+    // It may land in the same frame as the hit reaction; at that range nobody can tell.
+    static void ApplyFarImpulse(IWorld& world, const Settings& cfg, ActorId targetId,
+        const ActorState& aggressor, const ActorState& target, float weaponMult)
+    {
+        g_impulse.clear();
+        g_impulse.AddShove(aggressor.position, target.position, cfg, weaponMult);
+        ComputeShoveGeometry(g_impulse);
+
+        const auto g = LaneGeometry(g_impulse, 0);
+        const bool ok = ApplyPhysicsShove(world, targetId, g.dirX, g.dirY, g.magnitude, g.duration);
+        Metrics::Add(ok ? Metrics::Counter::kLodImpulse : Metrics::Counter::kLodImpulseFailed);
+        KB_TRACE("Shove: far impulse target={:08X} mag={} dur={} ok={}", targetId, g.magnitude, g.duration, ok);
+    }
 
-            auto aggressorPtr = aggressorH.get();
-            auto targetPtr = targetH.get();
+    // Player fights, and everything while the camera is unknown, are near. Only called with LOD on.
+    static Lod::Tier ClassifyHit(const IWorld& world, const Settings& cfg, LodCamera& camera,
+        const ActorState& aggressor, const ActorState& target)
+    {
+        if (aggressor.player || target.player) {
+            return Lod::Tier::kNear;
+        }
+        if (!camera.read) {
+            camera.read = true;
+            camera.known = world.GetCameraPosition(camera.position);
+        }
+        return camera.known ? Lod::Classify(cfg, HorizontalDistance(camera.position, target.position)) : Lod::Tier::kNear;
+    }
 
-            RE::Actor* aggressor = aggressorPtr ? aggressorPtr.get() : nullptr;
-            RE::Actor* target = targetPtr ? targetPtr.get() : nullptr;
+    // One attack: hits[0..count) share aggressor and weapon multiplier (a cleave or AoE swing
+    // sends one hit event per victim). Aggressor-side gates run once per attack; the
+    // separation controller later merges the aggressor's pushes away from all victims.
+    // F is cfg's HitPipeline::FeaturesOf; the stages of features it lacks are compiled out.
+    template <HitPipeline::Features F>
+    static void SubmitGatedAttack(IWorld& world, const SettingsPtr& cfg, const HitEvent* hits, std::size_t count,
+        std::uint64_t nowMicros, LodCamera& camera)
+    {
+        using Metrics::Counter;
+        Metrics::Add(Counter::kHitSubmitted, count);
+        Metrics::Record(Metrics::Histogram::kAttackVictims, count);
 
-            if (!aggressor || !target) return;
-            if (aggressor == target) return;
-            if (aggressor->IsDead() || target->IsDead()) return;
+        const ActorId aggressorId = hits[0].aggressor;
+        const float weaponMult = hits[0].weaponMult;
 
-            if (ShouldDisableDueToFirstPerson(aggressor)) {
-                logger::trace("Shove (queued): suppressed (player in first-person)");
+        ActorState aggressor{};
+        if (!world.GetActorState(aggressorId, aggressor)) {
+            Metrics::Add(Counter::kHitUnresolved, count);
+            return;
+        }
+        if (aggressor.dead) {
+            Metrics::Add(Counter::kHitDead, count);
+            return;
+        }
+
+        if constexpr ((F & HitPipeline::kFirstPerson) != 0) {
+            if (aggressor.player && world.SuppressedByFirstPerson(*cfg, aggressorId)) {
+                Metrics::Add(Counter::kHitFirstPerson, count);
                 return;
             }
+        }
 
-            if (!IsValidKnockbackTarget(target)) {
-                return;
+        if (weaponMult <= 0.0f) {
+            Metrics::Add(Counter::kHitNoWeapon, count);
+            KB_TRACE("Shove: weapon is not configured");
+            return;
+        }
+
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto& hit = hits[i];
+            if (hit.target == aggressorId) {
+                Metrics::Add(Counter::kHitSelf);
+                KB_TRACE("Shove: target == aggressor");
+                continue;
             }
 
-            // INI is authoritative: multiplier <= 0 means no shove
-            if (weaponMult <= 0.0f) {
-                logger::trace("Shove (queued): suppressed (weapon not configured)");
-                return;
+            ActorState target{};
+            if (!world.GetActorState(hit.target, target)) {
+                Metrics::Add(Counter::kHitUnresolved);
+                continue;
+            }
+            if (target.dead) {
+                Metrics::Add(Counter::kHitDead);
+                continue;
+            }
+
+            if (!world.IsValidTarget(*cfg, hit.target)) {
+                Metrics::Add(Counter::kHitInvalidTarget);
+                KB_TRACE("Shove: target not allowed (humanoid filter)");
+                continue;
             }
 
-            float mag = cfg.shoveMagnitude * weaponMult;
-            float dur = cfg.shoveDuration;
-            ShapeForApplyCurrent(mag, dur);
-
-            const float distBefore = HorizontalDistance(aggressor, target);
-            const bool ok = ApplyPhysicsShove(aggressor, target, mag, dur);
-
-            if (ok) {
-                logger::trace(
-                    "Shove (queued): applied mag={} dur={} mult={} triesLeftAfter={}",
-                    mag, dur, weaponMult, remainingTries - 1);
-
-                if (cfg.minShoveSeparationDelta > 0.0f) {
-                    QueueShoveEffectivenessCheck(
-                        aggressorH,
-                        targetH,
-                        remainingTries,
-                        distBefore,
-                        /*delayFrames*/ 1,
-                        weaponMult);
+            if constexpr ((F & HitPipeline::kDegrade) != 0) {
+                if (!aggressor.player && !target.player && !Budget::Allows(Budget::Level::kPlayerOnly)) {
+                    Metrics::Add(Counter::kDegradeSkipped);
+                    continue;
                 }
+            }
 
-                if (cfg.enforceMinSeparation && cfg.separationRetries > 0 && IsPlayer(aggressor)) {
-                    QueueEnforceMinSeparation(
-                        aggressorH,
-                        targetH,
-                        cfg.separationRetries,
-                        cfg.separationInitialDelayFrames);
+            // Mid: one attempt, no checks. Far: skipped, or a one-shot impulse right now.
+            auto lod = Lod::Tier::kNear;
+            if constexpr ((F & HitPipeline::kLod) != 0) {
+                lod = ClassifyHit(world, *cfg, camera, aggressor, target);
+            }
+            std::int32_t tries = 1;
+            switch (lod) {
+            case Lod::Tier::kNear:
+                if constexpr ((F & HitPipeline::kLod) != 0) {
+                    Metrics::Add(Counter::kLodNear);
                 }
-                return;
+                if constexpr ((F & HitPipeline::kAdaptive) != 0) {
+                    tries = Adaptive::ShoveTries(*cfg, { target.race, aggressor.player });
+                }
+                else {
+                    tries = cfg->shoveRetries;
+                }
+                break;
+            case Lod::Tier::kMid:
+                Metrics::Add(Counter::kLodMid);
+                break;
+            case Lod::Tier::kFar:
+                Metrics::Add(Counter::kLodFar);
+                if (cfg->lodFarImpulse) {
+                    ApplyFarImpulse(world, *cfg, hit.target, aggressor, target, weaponMult);
+                }
+                else {
+                    Metrics::Add(Counter::kLodFarSkipped);
+                }
+                continue;
             }
 
-            logger::trace(
-                "Shove (queued): failed mag={} dur={} mult={} triesLeftAfter={}",
-                mag, dur, weaponMult, remainingTries - 1);
+            KB_TRACE(
+                "Shove: queue target={:08X} aggressor={:08X} mag={} dur={} retries={} delayFrames={} lod={} DisableInFirstPerson={}",
+                hit.target, aggressorId,
+                cfg->shoveMagnitude * weaponMult, cfg->shoveDuration,
+                tries, cfg->shoveRetryDelayFrames, static_cast<int>(lod),
+                cfg->disableInFirstPerson);
 
-            const auto nextTries = remainingTries - 1;
-            if (nextTries > 0) {
-                QueuePhysicsShove(aggressorH, targetH, nextTries, cfg.shoveRetryDelayFrames, weaponMult);
-            }
-            });
+            const auto hitMicros = hit.postedMicros != 0 ? hit.postedMicros : nowMicros;
+            StartShoveChain(cfg, aggressorId, hit.target, tries, weaponMult, kAttackDeferralMaxFrames, hitMicros, lod);
+        }
     }
 
-    void QueuePhysicsShoveWithAttackDeferral(
-        RE::ActorHandle aggressorH,
-        RE::ActorHandle targetH,
-        std::int32_t tries,
-        float weaponMult,
-        std::int32_t remainingWaitFrames)
+    using SubmitAttackFn = void (*)(IWorld&, const SettingsPtr&, const HitEvent*, std::size_t, std::uint64_t, LodCamera&);
+
+    template <std::size_t... I>
+    static constexpr std::array<SubmitAttackFn, sizeof...(I)> MakeSubmitVariants(std::index_sequence<I...>)
     {
-        auto taskIf = SKSE::GetTaskInterface();
-        if (!taskIf) return;
+        return { &SubmitGatedAttack<static_cast<HitPipeline::Features>(I)>... };
+    }
 
-        taskIf->AddTask([=]() {
-            auto aPtr = aggressorH.get();
-            auto tPtr = targetH.get();
-            auto* aggressor = aPtr ? aPtr.get() : nullptr;
-            auto* target = tPtr ? tPtr.get() : nullptr;
-            if (!aggressor || !target) return;
+    static constexpr auto kSubmitVariants = MakeSubmitVariants(std::make_index_sequence<HitPipeline::kVariants>{});
 
-            // If still attacking, keep deferring until we hit the cap
-            if (remainingWaitFrames > 0 && GetIsAttacking(target)) {
-                constexpr std::int32_t poll = 1;
-                QueuePhysicsShoveWithAttackDeferral(
-                    aggressorH, targetH, tries, weaponMult,
-                    remainingWaitFrames - poll);
+    // The variant for the snapshot the drain last saw. Published snapshots are immutable and
+    // each carries a new epoch, so a changed pointer or epoch is the only time to pick again.
+    // Main-thread only (hit drain).
+    struct SelectedVariant
+    {
+        const Settings* snapshot{ nullptr };
+        std::uint64_t epoch{ 0 };
+        SubmitAttackFn submit{ nullptr };
+    };
 
-                logger::trace("Actor attacking. Deferring...");
-                return;
-            }
+    static SelectedVariant g_variant{};
+
+    static SubmitAttackFn SelectVariant(const Settings& cfg)
+    {
+        if (g_variant.snapshot != &cfg || g_variant.epoch != cfg.epoch || !g_variant.submit) {
+            const auto features = HitPipeline::FeaturesOf(cfg);
+            g_variant = { &cfg, cfg.epoch, kSubmitVariants[features] };
+            Metrics::Set(Metrics::Gauge::kHitPipeline, features);
+            KB_TRACE("Hit pipeline: epoch {} features {:X}", cfg.epoch, features);
+        }
+        return g_variant.submit;
+    }
+
+    void SubmitHit(const HitEvent& hit)
+    {
+        auto& world = GetWorld();
+        LodCamera camera{};
+        const auto cfg = world.AcquireSettings();
+        SelectVariant(*cfg)(world, cfg, &hit, 1, Metrics::NowMicros(), camera);
+    }
 
-            const auto& cfg = GetConfig();
-            QueuePhysicsShove(aggressorH, targetH, tries, cfg.shoveInitialDelayFrames, weaponMult);
-            });
+    void SubmitHits(const std::vector<HitEvent>& hits)
+    {
+        if (hits.empty()) {
+            return;
+        }
+
+        // One snapshot for the whole batch.
+        SubmitHits(GetWorld().AcquireSettings(), hits);
+    }
+
+    void SubmitHits(const SettingsPtr& cfg, const std::vector<HitEvent>& hits)
+    {
+        if (hits.empty()) {
+            return;
+        }
+
+        auto& world = GetWorld();
+        const auto now = Metrics::NowMicros();
+        const auto submit = SelectVariant(*cfg);
+        LodCamera camera{};
+
+        // The game sends a sweep's hit events back to back; group each run of one attack.
+        for (std::size_t first = 0; first < hits.size();) {
+            std::size_t end = first + 1;
+            while (end < hits.size() && hits[end].aggressor == hits[first].aggressor &&
+                   hits[end].weaponMult == hits[first].weaponMult) {
+                ++end;
+            }
+            submit(world, cfg, hits.data() + first, end - first, now, camera);
+            first = end;
+        }
     }
 }
@@ -0,0 +1,16 @@
+#include <Knockback/World.h>
+
+namespace Knockback
+{
+    static IWorld* g_world{ nullptr };
+
+    void SetWorld(IWorld& world)
+    {
+        g_world = &world;
+    }
+
+    IWorld& GetWorld()
+    {
+        return *g_world;
+    }
+}
@@ -1,7 +1,8 @@
 // plugin.cpp
-// Entry point only: SKSE init, logging, and messaging registration.
+// Entry point only: SKSE init, logging, messaging registration and the early config parse.
 
 #include "SKSE/SKSE.h"
+#include <Knockback/Config.h>
 #include <Knockback/Log.h>
 #include <Knockback/HitSink.h>
 
@@ -22,5 +23,8 @@ SKSEPluginLoad(const SKSE::LoadInterface* skse)
 
     messaging->RegisterListener(Knockback::OnSKSEMessage);
     logger::info("Registered SKSE messaging listener");
+
+    // The INI half of the config load runs while the game loads its data; kDataLoaded joins it.
+    Knockback::BeginConfigLoad();
     return true;
 }
\ No newline at end of file
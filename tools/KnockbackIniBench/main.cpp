@@ -0,0 +1,504 @@
+// KnockbackIniBench
+// Times the config load's INI stage both ways on generated files: the SimpleIni path
+// LoadConfig used to take (three file loads, a lookup per key, allocating FormSpec helpers)
+// against the schema-driven loader (Ini.h, SettingsSchema.h). Both must produce the same
+// Settings and the same FormSpec tokens, or the run fails. A second stage resolves the
+// file's FormSpecs against a synthetic load order of P plugins, once with a by-name lookup
+// per entry (what TESDataHandler::LookupFormID does) and once through FormSpecs::Batch,
+// and requires the same FormIDs from both.
+//
+//   KnockbackIniBench [--keywords N] [--races N] [--plugins P] [--repeat R] [--dir D]
+//
+// N weapon keyword multipliers and N Allow/Deny race lines go into the legacy file; the MCM
+// file carries the typed overrides. Each repeat is one full startup/reload read of both files.
+
+#include <Knockback/FormSpecs.h>
+#include <Knockback/Ini.h>
+#include <Knockback/SettingsSchema.h>
+
+#include "SimpleIni.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace Knockback;
+namespace fs = std::filesystem;
+
+// Counts heap allocations so the report can show what each path costs beyond time.
+static std::atomic<std::uint64_t> g_heapAllocations{ 0 };
+
+void* operator new(std::size_t size)
+{
+    g_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace
+{
+    struct Options
+    {
+        std::size_t keywords{ 2000 };
+        std::size_t races{ 2000 };
+        std::size_t plugins{ 250 };
+        std::size_t repeat{ 50 };
+        fs::path dir{ fs::temp_directory_path() };
+    };
+
+    // A FormSpec reduced to what the game lookup needs; the lookup itself is not timed.
+    struct Token
+    {
+        std::uint32_t fileHash{ 0 };
+        std::uint32_t localID{ 0 };
+        float mult{ 0.0f };
+        bool operator==(const Token&) const = default;
+    };
+
+    std::uint32_t HashName(std::string_view s)
+    {
+        std::uint32_t h = 2166136261u;
+        for (char c : s) {
+            h = (h ^ static_cast<std::uint8_t>(c)) * 16777619u;
+        }
+        return h;
+    }
+
+    struct Result
+    {
+        Settings settings;
+        std::vector<Token> tokens;
+    };
+
+    void WriteFiles(const Options& opts, const fs::path& legacy, const fs::path& mcm)
+    {
+        std::string text = "; generated by KnockbackIniBench\n[General]\n";
+        char line[160];
+        for (const auto& field : Schema::Fields()) {
+            if (field.section != "General") {
+                continue;
+            }
+            const char* value = field.type == Schema::Type::kBool ? "true" : field.type == Schema::Type::kInt ? "2" : "1.75";
+            std::snprintf(line, sizeof(line), "%.*s = %s\n", static_cast<int>(field.key.size()), field.key.data(), value);
+            text += line;
+        }
+
+        text += "\n[WeaponMultipliers]\nUnarmed = 0.9\nPowerAttack = 1.3\n";
+        for (std::size_t i = 0; i < opts.keywords; ++i) {
+            std::snprintf(line, sizeof(line), "Mod%03zu.esp|0x%06zX = %.2f ; keyword %zu\n", i % 97, 0x800 + i % 0x7FF, 0.5 + (i % 20) * 0.1, i);
+            text += line;
+        }
+
+        text += "\n[Races]\n";
+        for (std::size_t i = 0; i < opts.races; ++i) {
+            std::snprintf(line, sizeof(line), "%s = Skyrim.esm|0x%06zX\n", i % 3 ? "Allow" : "Deny", 0x13740 + i);
+            text += line;
+        }
+        text += "\n[Logging]\nStatsInterval = 30\n";
+
+        std::string mcmText;
+        Settings overrides{};
+        overrides.shoveMagnitude = 3.25f;
+        overrides.separationRetries = 4;
+        overrides.disableInFirstPerson = false;
+        mcmText = Schema::FormatMcm(overrides);
+
+        std::FILE* f = std::fopen(legacy.string().c_str(), "wb");
+        std::FILE* g = std::fopen(mcm.string().c_str(), "wb");
+        if (f) {
+            std::fwrite(text.data(), 1, text.size(), f);
+            std::fclose(f);
+        }
+        if (g) {
+            std::fwrite(mcmText.data(), 1, mcmText.size(), g);
+            std::fclose(g);
+        }
+    }
+
+    // ---- Before: the SimpleIni path and helpers LoadConfig used ----
+
+    std::string Trim(std::string s)
+    {
+        auto notSpace = [](char c) { return !std::isspace(static_cast<unsigned char>(c)); };
+        s.erase(s.begin(), std::find_if(s.begin(), s.end(), notSpace));
+        s.erase(std::find_if(s.rbegin(), s.rend(), notSpace).base(), s.end());
+        return s;
+    }
+
+    std::string StripIniComment(std::string s)
+    {
+        const auto pos = s.find_first_of(";#");
+        if (pos != std::string::npos) {
+            s.erase(pos);
+        }
+        return Trim(std::move(s));
+    }
+
+    bool TokenizeBefore(const std::string& spec, Token& out)
+    {
+        const auto cleaned = StripIniComment(spec);
+        const auto bar = cleaned.find('|');
+        if (bar == std::string::npos) {
+            return false;
+        }
+        const std::string file = Trim(cleaned.substr(0, bar));
+        std::string hex = Trim(cleaned.substr(bar + 1));
+        if (hex.rfind("0x", 0) == 0 || hex.rfind("0X", 0) == 0) {
+            hex = Trim(hex.substr(2));
+        }
+        if (file.empty() || hex.empty()) {
+            return false;
+        }
+        try {
+            out.localID = static_cast<std::uint32_t>(std::stoul(hex, nullptr, 16));
+        }
+        catch (...) {
+            return false;
+        }
+        out.fileHash = HashName(file);
+        return true;
+    }
+
+    bool LoadSimpleIni(CSimpleIniA& ini, const fs::path& path)
+    {
+        ini.Reset();
+        ini.SetUnicode();
+        ini.SetMultiKey();
+        return ini.LoadFile(path.string().c_str()) >= 0;
+    }
+
+    void ApplySimpleIni(const CSimpleIniA& ini, const Schema::Field& field, const char* key, Settings& s)
+    {
+        switch (field.type) {
+        case Schema::Type::kFloat:
+            s.*field.f = static_cast<float>(ini.GetDoubleValue(std::string(field.section).c_str(), key, s.*field.f));
+            break;
+        case Schema::Type::kInt:
+            s.*field.i = static_cast<std::int32_t>(ini.GetLongValue(std::string(field.section).c_str(), key, s.*field.i));
+            break;
+        case Schema::Type::kBool:
+            s.*field.b = ini.GetBoolValue(std::string(field.section).c_str(), key, s.*field.b);
+            break;
+        }
+    }
+
+    Result LoadBefore(const fs::path& legacyPath, const fs::path& mcmPath)
+    {
+        Result r{};
+        CSimpleIniA legacy;
+        CSimpleIniA mcm;
+        LoadSimpleIni(legacy, legacyPath);
+        LoadSimpleIni(mcm, mcmPath);
+
+        for (const auto& field : Schema::Fields()) {
+            ApplySimpleIni(legacy, field, std::string(field.key).c_str(), r.settings);
+        }
+
+        CSimpleIniA::TNamesDepend keys;
+        legacy.GetAllKeys("WeaponMultipliers", keys);
+        keys.sort(CSimpleIniA::Entry::LoadOrder());
+        for (const auto& k : keys) {
+            std::string_view key{ k.pItem };
+            if (key == "Unarmed" || key == "PowerAttack") continue;
+            const char* value = legacy.GetValue("WeaponMultipliers", k.pItem, nullptr);
+            Token t{};
+            try { t.mult = std::stof(value); }
+            catch (...) { continue; }
+            if (TokenizeBefore(std::string(key), t)) r.tokens.push_back(t);
+        }
+        for (const char* list : { "Allow", "Deny" }) {
+            CSimpleIniA::TNamesDepend values;
+            legacy.GetAllValues("Races", list, values);
+            for (const auto& v : values) {
+                Token t{};
+                if (TokenizeBefore(v.pItem, t)) r.tokens.push_back(t);
+            }
+        }
+
+        // The seed step's existence check, then the MCM file a second time.
+        (void)fs::exists(mcmPath);
+        LoadSimpleIni(mcm, mcmPath);
+        for (const auto& field : Schema::Fields()) {
+            if (!field.mcm) continue;
+            const std::string section(field.section);
+            const std::string plain(field.key);
+            const std::string typed = (field.type == Schema::Type::kFloat ? "f" : field.type == Schema::Type::kInt ? "i" : "b") + plain;
+            if (mcm.KeyExists(section.c_str(), typed.c_str())) ApplySimpleIni(mcm, field, typed.c_str(), r.settings);
+            else if (mcm.KeyExists(section.c_str(), plain.c_str())) ApplySimpleIni(mcm, field, plain.c_str(), r.settings);
+        }
+        Schema::Clamp(r.settings);
+        return r;
+    }
+
+    // ---- After: mapped files, one pass each, schema table, string_view helpers ----
+
+    bool TokenizeAfter(std::string_view spec, Token& out)
+    {
+        const auto cleaned = Ini::StripComment(spec);
+        const auto bar = cleaned.find('|');
+        if (bar == std::string_view::npos) {
+            return false;
+        }
+        const auto file = Ini::Trim(cleaned.substr(0, bar));
+        auto hex = Ini::Trim(cleaned.substr(bar + 1));
+        if (hex.starts_with("0x") || hex.starts_with("0X")) {
+            hex = Ini::Trim(hex.substr(2));
+        }
+        if (file.empty() || hex.empty() || !Ini::ParseHexPrefix(hex, out.localID)) {
+            return false;
+        }
+        out.fileHash = HashName(file);
+        return true;
+    }
+
+    Result LoadAfter(const fs::path& legacyPath, const fs::path& mcmPath)
+    {
+        Result r{};
+        std::array<std::byte, 16 * 1024> arenaBuffer;
+        std::pmr::monotonic_buffer_resource arena(arenaBuffer.data(), arenaBuffer.size());
+        Ini::Document legacy(&arena);
+        Ini::Document mcm(&arena);
+        legacy.Load(legacyPath);
+        mcm.Load(mcmPath);
+
+        Schema::Apply(legacy, Schema::Layer::kLegacy, r.settings);
+
+        // Same order as the SimpleIni walk: multipliers, then Allow, then Deny.
+        for (const auto& e : legacy.Entries()) {
+            if (!Ini::IEquals(e.section, "WeaponMultipliers") || Ini::IEquals(e.key, "Unarmed") || Ini::IEquals(e.key, "PowerAttack")) continue;
+            Token t{};
+            if (!Ini::ParseFloat(Ini::StripComment(e.value), t.mult)) continue;
+            if (TokenizeAfter(e.key, t)) r.tokens.push_back(t);
+        }
+        for (std::string_view list : { "Allow", "Deny" }) {
+            for (const auto& e : legacy.Entries()) {
+                Token t{};
+                if (Ini::IEquals(e.section, "Races") && Ini::IEquals(e.key, list) && TokenizeAfter(e.value, t)) r.tokens.push_back(t);
+            }
+        }
+
+        Schema::Apply(mcm, Schema::Layer::kMcm, r.settings);
+        Schema::Clamp(r.settings);
+        return r;
+    }
+
+    // ---- FormSpec resolution: a load-order lookup per entry vs. one batch ----
+
+    // A load order like the game's: full plugins by compile index, every fourth Mod plugin
+    // an ESL in the FE block, every 40th one not installed (so the report has something).
+    struct LoadOrder final : FormSpecs::IPluginTable
+    {
+        struct File
+        {
+            std::string name;
+            FormSpecs::PluginSlot slot;
+        };
+        std::vector<File> files;
+
+        explicit LoadOrder(std::size_t count)
+        {
+            files.push_back(File{ "Skyrim.esm", { 0, false } });
+            std::uint16_t full = 1;
+            std::uint16_t light = 0;
+            char name[32];
+            for (std::size_t i = 0; i < count; ++i) {
+                if (i % 40 == 39) continue;
+                std::snprintf(name, sizeof(name), "mod%03zu.ESP", i);   // other case than the INI
+                const bool isLight = i % 4 == 3;
+                files.push_back(File{ name, { isLight ? light++ : full++, isLight } });
+            }
+        }
+
+        // By name over the whole list, as TESDataHandler::LookupModByName walks its files.
+        std::optional<FormSpecs::PluginSlot> Find(std::string_view name) const override
+        {
+            for (const auto& file : files) {
+                if (Ini::IEquals(file.name, name)) return file.slot;
+            }
+            return std::nullopt;
+        }
+    };
+
+    std::vector<std::string_view> CollectSpecs(const Ini::Document& legacy)
+    {
+        std::vector<std::string_view> specs;
+        for (const auto& e : legacy.Entries()) {
+            if (Ini::IEquals(e.section, "WeaponMultipliers") && !Ini::IEquals(e.key, "Unarmed") && !Ini::IEquals(e.key, "PowerAttack")) {
+                specs.push_back(e.key);
+            }
+            else if (Ini::IEquals(e.section, "Races")) {
+                specs.push_back(e.value);
+            }
+        }
+        return specs;
+    }
+
+    // LoadConfig's old ParseFormSpec: parse, then find the plugin by name and build the ID.
+    std::vector<std::uint32_t> ResolveEach(const LoadOrder& order, const std::vector<std::string_view>& specs)
+    {
+        std::vector<std::uint32_t> ids;
+        ids.reserve(specs.size());
+        for (const auto spec : specs) {
+            Token t{};
+            const auto cleaned = Ini::StripComment(spec);
+            const auto bar = cleaned.find('|');
+            if (!TokenizeAfter(spec, t) || bar == std::string_view::npos) continue;
+            const auto slot = order.Find(Ini::Trim(cleaned.substr(0, bar)));
+            ids.push_back(slot ? FormSpecs::ToFormID(*slot, t.localID) : 0);
+        }
+        return ids;
+    }
+
+    std::vector<std::uint32_t> ResolveBatch(const LoadOrder& order, const std::vector<std::string_view>& specs, std::string* report)
+    {
+        std::array<std::byte, 16 * 1024> arenaBuffer;
+        std::pmr::monotonic_buffer_resource arena(arenaBuffer.data(), arenaBuffer.size());
+        FormSpecs::Batch batch(&arena);
+        std::pmr::vector<FormSpecs::Batch::Handle> handles(&arena);
+        handles.reserve(specs.size());
+        for (const auto spec : specs) {
+            if (const auto h = batch.Add(spec); h != FormSpecs::Batch::kInvalid) handles.push_back(h);
+        }
+        batch.Resolve(order);
+
+        std::vector<std::uint32_t> ids;
+        ids.reserve(handles.size());
+        for (const auto h : handles) {
+            ids.push_back(batch.FormID(h));
+        }
+        if (report) *report = batch.Report();
+        return ids;
+    }
+
+    bool SameSettings(const Settings& a, const Settings& b)
+    {
+        for (const auto& field : Schema::Fields()) {
+            const bool same = field.type == Schema::Type::kFloat ? a.*field.f == b.*field.f :
+                              field.type == Schema::Type::kInt   ? a.*field.i == b.*field.i :
+                                                                   a.*field.b == b.*field.b;
+            if (!same) {
+                std::printf("MISMATCH in %.*s/%.*s\n", static_cast<int>(field.section.size()), field.section.data(),
+                    static_cast<int>(field.key.size()), field.key.data());
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <class Fn>
+    void Time(const char* name, std::size_t repeat, Fn&& fn, double& meanOut)
+    {
+        std::vector<double> micros;
+        const auto allocsBefore = g_heapAllocations.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < repeat; ++i) {
+            const auto start = std::chrono::steady_clock::now();
+            fn();
+            micros.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        }
+        const auto allocs = g_heapAllocations.load(std::memory_order_relaxed) - allocsBefore;
+
+        const double first = micros.front();
+        std::sort(micros.begin(), micros.end());
+        double sum = 0.0;
+        for (double m : micros) sum += m;
+        meanOut = sum / static_cast<double>(micros.size());
+        std::printf("%-8s first=%9.1f us  mean=%9.1f us  p50=%9.1f us  allocations/load=%llu\n", name, first, meanOut,
+            micros[micros.size() / 2], static_cast<unsigned long long>(allocs / repeat));
+    }
+
+    bool ParseArgs(int argc, char** argv, Options& opts)
+    {
+        for (int i = 1; i < argc; ++i) {
+            const char* arg = argv[i];
+            const char* val = i + 1 < argc ? argv[i + 1] : nullptr;
+            if (!val) {
+                return false;
+            }
+
+            if (std::strcmp(arg, "--keywords") == 0) opts.keywords = std::strtoull(val, nullptr, 10);
+            else if (std::strcmp(arg, "--races") == 0) opts.races = std::strtoull(val, nullptr, 10);
+            else if (std::strcmp(arg, "--plugins") == 0) opts.plugins = std::strtoull(val, nullptr, 10);
+            else if (std::strcmp(arg, "--repeat") == 0) opts.repeat = std::max<std::size_t>(1, std::strtoull(val, nullptr, 10));
+            else if (std::strcmp(arg, "--dir") == 0) opts.dir = val;
+            else return false;
+            ++i;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options opts{};
+    if (!ParseArgs(argc, argv, opts)) {
+        std::fprintf(stderr, "usage: %s [--keywords N] [--races N] [--plugins P] [--repeat R] [--dir D]\n", argv[0]);
+        return 2;
+    }
+
+    const auto legacyPath = opts.dir / "KnockbackIniBench.ini";
+    const auto mcmPath = opts.dir / "KnockbackIniBench.mcm.ini";
+    WriteFiles(opts, legacyPath, mcmPath);
+    std::printf("legacy %s: %llu bytes, mcm: %llu bytes\n", legacyPath.string().c_str(),
+        static_cast<unsigned long long>(fs::file_size(legacyPath)), static_cast<unsigned long long>(fs::file_size(mcmPath)));
+
+    const auto before = LoadBefore(legacyPath, mcmPath);
+    const auto after = LoadAfter(legacyPath, mcmPath);
+    const bool same = SameSettings(before.settings, after.settings) && before.tokens == after.tokens;
+
+    double beforeMean = 0.0;
+    double afterMean = 0.0;
+    Time("simpleini", opts.repeat, [&] { (void)LoadBefore(legacyPath, mcmPath); }, beforeMean);
+    Time("schema", opts.repeat, [&] { (void)LoadAfter(legacyPath, mcmPath); }, afterMean);
+    std::printf("speedup=%.2fx tokens=%zu\n", afterMean > 0.0 ? beforeMean / afterMean : 0.0, after.tokens.size());
+
+    // Resolution stage, on the specs of the parsed legacy file.
+    std::array<std::byte, 4096> docBuffer;
+    std::pmr::monotonic_buffer_resource docArena(docBuffer.data(), docBuffer.size());
+    Ini::Document legacyDoc(&docArena);
+    legacyDoc.Load(legacyPath);
+    const auto specs = CollectSpecs(legacyDoc);
+    const LoadOrder order(opts.plugins);
+
+    std::string report;
+    const bool sameIDs = ResolveEach(order, specs) == ResolveBatch(order, specs, &report);
+    double eachMean = 0.0;
+    double batchMean = 0.0;
+    Time("lookup", opts.repeat, [&] { (void)ResolveEach(order, specs); }, eachMean);
+    Time("batch", opts.repeat, [&] { (void)ResolveBatch(order, specs, nullptr); }, batchMean);
+    std::printf("speedup=%.2fx specs=%zu loadOrder=%zu\n", batchMean > 0.0 ? eachMean / batchMean : 0.0, specs.size(), order.files.size());
+    std::printf("report: %s\n", report.empty() ? "(all resolved)" : report.c_str());
+
+    fs::remove(legacyPath);
+    fs::remove(mcmPath);
+
+    if (!same || !sameIDs) {
+        std::printf("results differ\n");
+        return 1;
+    }
+    std::printf("results identical\n");
+    return 0;
+}
@@ -0,0 +1,264 @@
+// KnockbackLogDecode
+// Renders a binary trace (KnockbackPlugin.kblog) back into text lines.
+//
+//   KnockbackLogDecode <KnockbackPlugin.kblog> [out.txt]
+
+#include <Knockback/BinLogFormat.h>
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+using namespace Knockback::BinLog;
+
+namespace
+{
+    struct Spec
+    {
+        bool zeroPad{ false };
+        int width{ -1 };
+        int precision{ -1 };
+        char type{ 0 };
+    };
+
+    // Subset of the std::format spec mini-language the plugin actually uses: [0][width][.prec][type]
+    Spec ParseSpec(std::string_view s)
+    {
+        Spec spec{};
+        std::size_t i = 0;
+        if (i < s.size() && s[i] == '0') {
+            spec.zeroPad = true;
+            ++i;
+        }
+        if (i < s.size() && s[i] >= '0' && s[i] <= '9') {
+            const auto r = std::from_chars(s.data() + i, s.data() + s.size(), spec.width);
+            i = static_cast<std::size_t>(r.ptr - s.data());
+        }
+        if (i < s.size() && s[i] == '.') {
+            ++i;
+            const auto r = std::from_chars(s.data() + i, s.data() + s.size(), spec.precision);
+            i = static_cast<std::size_t>(r.ptr - s.data());
+        }
+        if (i < s.size()) {
+            spec.type = s[i];
+        }
+        return spec;
+    }
+
+    std::string PrintfPrefix(const Spec& spec)
+    {
+        std::string p = "%";
+        if (spec.zeroPad) p += '0';
+        if (spec.width >= 0) p += std::to_string(spec.width);
+        if (spec.precision >= 0) p += "." + std::to_string(spec.precision);
+        return p;
+    }
+
+    template <class T>
+    std::string Shortest(T v)
+    {
+        char buf[64];
+        const auto r = std::to_chars(buf, buf + sizeof(buf), v);
+        return std::string(buf, r.ptr);
+    }
+
+    std::string FormatArg(ArgTag tag, std::uint64_t bits, const Spec& spec)
+    {
+        char buf[128];
+        const auto prefix = PrintfPrefix(spec);
+
+        switch (tag) {
+        case ArgTag::kBool:
+            return bits ? "true" : "false";
+        case ArgTag::kI64:
+        case ArgTag::kU64:
+            {
+                std::string conv = "ll";
+                switch (spec.type) {
+                case 'X': conv += 'X'; break;
+                case 'x': conv += 'x'; break;
+                default: conv += (tag == ArgTag::kI64 ? 'd' : 'u'); break;
+                }
+                std::snprintf(buf, sizeof(buf), (prefix + conv).c_str(), static_cast<unsigned long long>(bits));
+                return buf;
+            }
+        case ArgTag::kF32:
+        case ArgTag::kF64:
+            {
+                double d = 0.0;
+                float f = 0.0f;
+                if (tag == ArgTag::kF32) {
+                    const auto u = static_cast<std::uint32_t>(bits);
+                    std::memcpy(&f, &u, sizeof(f));
+                    d = f;
+                }
+                else {
+                    std::memcpy(&d, &bits, sizeof(d));
+                }
+
+                if (spec.type == 0 && spec.precision < 0) {
+                    return tag == ArgTag::kF32 ? Shortest(f) : Shortest(d);
+                }
+                const char conv = (spec.type == 'e' || spec.type == 'g') ? spec.type : 'f';
+                std::snprintf(buf, sizeof(buf), (prefix + conv).c_str(), d);
+                return buf;
+            }
+        default:
+            return "?";
+        }
+    }
+
+    std::string Render(std::string_view fmt, const Record& r)
+    {
+        std::string out;
+        std::size_t argIndex = 0;
+
+        for (std::size_t i = 0; i < fmt.size(); ++i) {
+            const char c = fmt[i];
+            if ((c == '{' || c == '}') && i + 1 < fmt.size() && fmt[i + 1] == c) {
+                out += c;
+                ++i;
+                continue;
+            }
+            if (c != '{') {
+                out += c;
+                continue;
+            }
+
+            const auto close = fmt.find('}', i);
+            if (close == std::string_view::npos) {
+                out.append(fmt.substr(i));
+                break;
+            }
+
+            const auto field = fmt.substr(i + 1, close - i - 1);
+            const auto colon = field.find(':');
+            const auto spec = ParseSpec(colon == std::string_view::npos ? std::string_view{} : field.substr(colon + 1));
+
+            if (argIndex < r.argc && argIndex < kMaxArgs) {
+                out += FormatArg(r.tags[argIndex], r.args[argIndex], spec);
+            }
+            else {
+                out += "{?}";
+            }
+            ++argIndex;
+            i = close;
+        }
+        return out;
+    }
+
+    std::string Timestamp(std::uint64_t ns)
+    {
+        const auto secs = static_cast<std::time_t>(ns / 1'000'000'000ull);
+        const auto micros = static_cast<unsigned>((ns / 1'000ull) % 1'000'000ull);
+
+        char buf[64]{};
+        if (const auto* tm = std::localtime(&secs)) {
+            std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", tm);
+        }
+        return std::string(buf) + "." + std::to_string(1'000'000 + micros).substr(1);
+    }
+
+    template <class T>
+    bool ReadValue(std::FILE* f, T& out)
+    {
+        return std::fread(&out, sizeof(T), 1, f) == 1;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <file.kblog> [out.txt]\n", argv[0]);
+        return 2;
+    }
+
+    std::FILE* in = std::fopen(argv[1], "rb");
+    if (!in) {
+        std::fprintf(stderr, "cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    std::FILE* out = stdout;
+    if (argc >= 3) {
+        out = std::fopen(argv[2], "w");
+        if (!out) {
+            std::fprintf(stderr, "cannot write %s\n", argv[2]);
+            std::fclose(in);
+            return 1;
+        }
+    }
+
+    FileHeader header{};
+    if (!ReadValue(in, header) || header.magic != kFileMagic) {
+        std::fprintf(stderr, "%s is not a Knockback binary trace\n", argv[1]);
+        return 1;
+    }
+    if (header.version != kFileVersion || header.recordSize != sizeof(Record)) {
+        std::fprintf(stderr, "unsupported trace version %u (record size %u)\n", header.version, header.recordSize);
+        return 1;
+    }
+
+    std::unordered_map<std::uint16_t, std::string> formats;
+    std::size_t records = 0;
+    std::uint64_t dropped = 0;
+
+    std::uint8_t tag = 0;
+    while (ReadValue(in, tag)) {
+        switch (static_cast<ChunkTag>(tag)) {
+        case ChunkTag::kFormat:
+            {
+                std::uint16_t id = 0;
+                std::uint16_t len = 0;
+                if (!ReadValue(in, id) || !ReadValue(in, len)) {
+                    break;
+                }
+                std::string fmt(len, '\0');
+                if (len && std::fread(fmt.data(), 1, len, in) != len) {
+                    break;
+                }
+                formats[id] = std::move(fmt);
+                continue;
+            }
+        case ChunkTag::kRecord:
+            {
+                Record r{};
+                if (!ReadValue(in, r)) {
+                    break;
+                }
+                const auto it = formats.find(r.formatId);
+                const auto text = it != formats.end() ? Render(it->second, r) : "<unknown format " + std::to_string(r.formatId) + ">";
+                std::fprintf(out, "[%s] [trace] [t%u] %s\n", Timestamp(r.timestampNs).c_str(), r.threadIndex, text.c_str());
+                ++records;
+                continue;
+            }
+        case ChunkTag::kDropped:
+            {
+                std::uint64_t n = 0;
+                if (!ReadValue(in, n)) {
+                    break;
+                }
+                dropped += n;
+                std::fprintf(out, "[dropped %llu records: ring full]\n", static_cast<unsigned long long>(n));
+                continue;
+            }
+        default:
+            std::fprintf(stderr, "corrupt chunk tag 0x%02X after %zu records\n", tag, records);
+            break;
+        }
+        break;
+    }
+
+    std::fprintf(stderr, "%zu records, %zu formats, %llu dropped\n",
+        records, formats.size(), static_cast<unsigned long long>(dropped));
+
+    std::fclose(in);
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    return 0;
+}
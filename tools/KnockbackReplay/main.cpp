@@ -0,0 +1,140 @@
+// KnockbackReplay
+// Feeds a capture (KnockbackPlugin.kbcap, or KnockbackSim --capture) back through the hit
+// gates, chain registry, scheduler and job runners. Every world read and ApplyCurrent the
+// core makes has to match the capture, in order; the first mismatch is reported. The core
+// is timed per hit batch and per task, so a recorded session doubles as a benchmark.
+//
+//   KnockbackReplay <capture.kbcap> [--stats out.txt]
+//
+// Exit code: 0 identical decisions, 1 diverged, 2 unreadable capture.
+
+#include <Knockback/Adaptive.h>
+#include <Knockback/Capture.h>
+#include <Knockback/Metrics.h>
+#include <Knockback/Tasks.h>
+#include <Knockback/World.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace Knockback;
+
+namespace
+{
+    double Percentile(std::vector<double> v, double p)
+    {
+        if (v.empty()) {
+            return 0.0;
+        }
+        const auto k = static_cast<std::size_t>(p * static_cast<double>(v.size() - 1));
+        std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(k), v.end());
+        return v[k];
+    }
+
+    double Sum(const std::vector<double>& v)
+    {
+        double total = 0.0;
+        for (const auto x : v) {
+            total += x;
+        }
+        return total;
+    }
+
+    void PrintTimes(const char* what, const std::vector<double>& micros)
+    {
+        const double total = Sum(micros);
+        std::printf("%-6s n=%zu total=%.1fus mean=%.2f p50=%.2f p99=%.2f max=%.2f\n", what, micros.size(), total,
+            micros.empty() ? 0.0 : total / static_cast<double>(micros.size()), Percentile(micros, 0.50),
+            Percentile(micros, 0.99), micros.empty() ? 0.0 : *std::max_element(micros.begin(), micros.end()));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const char* capturePath = nullptr;
+    const char* statsPath = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--stats") == 0 && i + 1 < argc) {
+            statsPath = argv[++i];
+        }
+        else if (!capturePath) {
+            capturePath = argv[i];
+        }
+        else {
+            capturePath = nullptr;
+            break;
+        }
+    }
+    if (!capturePath) {
+        std::fprintf(stderr, "usage: %s <capture.kbcap> [--stats out.txt]\n", argv[0]);
+        return 2;
+    }
+
+    Capture::ReplayWorld world;
+    if (!world.Open(capturePath)) {
+        std::fprintf(stderr, "%s: %s\n", capturePath, world.Error().c_str());
+        return 2;
+    }
+    SetWorld(world);
+
+    std::vector<double> batchMicros;
+    std::vector<double> taskMicros;
+    std::size_t hits = 0;
+
+    using Clock = std::chrono::steady_clock;
+    for (bool done = false; !done;) {
+        switch (world.Next()) {
+        case Capture::ReplayWorld::Step::kHits:
+            {
+                const auto start = Clock::now();
+                SubmitHits(world.LastHits());
+                batchMicros.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+                hits += world.LastHits().size();
+                break;
+            }
+        case Capture::ReplayWorld::Step::kTask:
+            {
+                const auto start = Clock::now();
+                world.RunNextTask();
+                taskMicros.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+                break;
+            }
+        case Capture::ReplayWorld::Step::kRawHit:
+            break;
+        case Capture::ReplayWorld::Step::kEnd:
+        case Capture::ReplayWorld::Step::kDiverged:
+            done = true;
+            break;
+        }
+    }
+
+    std::printf("capture=%s rawHits=%llu hits=%zu batches=%zu tasks=%zu applyCurrentCalls=%llu maxApplyDelta=%g\n",
+        capturePath, static_cast<unsigned long long>(world.RawHits()), hits, batchMicros.size(), taskMicros.size(),
+        static_cast<unsigned long long>(world.ApplyCurrentCalls()), static_cast<double>(world.MaxApplyDelta()));
+    PrintTimes("hits", batchMicros);
+    PrintTimes("tasks", taskMicros);
+    const double total = Sum(batchMicros) + Sum(taskMicros);
+    std::printf("per hit ns (amortized, incl. jobs): %.1f\n", hits ? total * 1000.0 / static_cast<double>(hits) : 0.0);
+
+    if (statsPath) {
+        if (std::FILE* stats = std::fopen(statsPath, "w")) {
+            const auto text = Metrics::Format(Metrics::Collect(), nullptr) + Adaptive::FormatTable();
+            std::fwrite(text.data(), 1, text.size(), stats);
+            std::fclose(stats);
+        }
+    }
+
+    if (world.Truncated()) {
+        std::printf("capture ends mid-event; replayed up to byte %zu\n", world.Offset());
+    }
+    if (world.Diverged()) {
+        std::printf("DIVERGED: %s\n", world.Error().c_str());
+        return 1;
+    }
+    std::printf("decisions identical\n");
+    return 0;
+}
@@ -0,0 +1,571 @@
+// KnockbackSim
+// Runs the shove core (hit gates, chain registry, scheduler, job runners) against a
+// synthetic world and reports the CPU cost per simulated frame. No game required.
+//
+//   KnockbackSim [--actors N] [--hits H] [--frames F] [--seed S] [--csv out.csv] [--trace out.kblog] [--stats out.txt]
+//                [--capture out.kbcap] [--adaptive 0|1] [--cleave K] [--budget-jobs N] [--budget-us U]
+//                [--lod-mid D] [--lod-far D] [--lod-far-impulse 0|1] [--attack-events 0|1]
+//   KnockbackSim --kernel-check N [--seed S]
+//
+// H synthetic hits are submitted every frame; the time measured per frame covers
+// the batched SubmitHits (what the game's hit inbox drain calls) plus the scheduler
+// tick that runs due jobs.
+// --stats writes the pipeline counters and histograms (Metrics.h) after the run, in the
+// same format as the plugin's stats file.
+// --capture records the run in the plugin's capture format, for tools/KnockbackReplay.
+// --adaptive 1 turns on the learned retry policy (Adaptive.h); --stats then shows its table.
+// --cleave K makes every player swing hit K victims (one attack, see Tasks.h).
+// --budget-jobs / --budget-us set the per-frame budget (Budget.h); the camera sits on the player.
+// --lod-mid / --lod-far set the distance LOD tiers (Lod.h); the world spans +-4096 units.
+// --attack-events 1 reports attack start/end as events (AttackTracker.h) instead of being polled.
+// --kernel-check compares the vectorized shove geometry against the scalar reference
+// on N random lanes and times both.
+
+#include <Knockback/Adaptive.h>
+#include <Knockback/BinLog.h>
+#include <Knockback/Capture.h>
+#include <Knockback/FlatMap.h>
+#include <Knockback/Metrics.h>
+#include <Knockback/Registry.h>
+#include <Knockback/Scheduler.h>
+#include <Knockback/Settings.h>
+#include <Knockback/ShoveKernel.h>
+#include <Knockback/Tasks.h>
+#include <Knockback/World.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace Knockback;
+
+// Counts heap allocations so the report can show whether the core allocates per frame.
+static std::atomic<std::uint64_t> g_heapAllocations{ 0 };
+
+void* operator new(std::size_t size)
+{
+    g_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace
+{
+    // Mirrors the plugin's TargetFlags so the synthetic filter follows the same rules.
+    enum SimTargetFlags : std::uint8_t
+    {
+        kListDenied = 1 << 0,
+        kListAllowed = 1 << 1,
+        kKeywordDenied = 1 << 2,
+        kKeywordAllowed = 1 << 3
+    };
+
+    // ApplyCurrent takes Havok units/s; positions are in game units.
+    constexpr float kHavokToSkyrim = 69.99f;
+    constexpr float kFrameSeconds = 1.0f / 60.0f;
+    constexpr float kWorldExtent = 4096.0f;
+
+    struct Options
+    {
+        std::size_t actors{ 256 };
+        std::size_t hitsPerFrame{ 64 };
+        std::size_t frames{ 600 };
+        std::uint32_t seed{ 1 };
+        const char* csvPath{ nullptr };
+        const char* tracePath{ nullptr };
+        const char* statsPath{ nullptr };
+        const char* capturePath{ nullptr };
+        std::size_t kernelCheckLanes{ 0 };
+        bool adaptive{ false };
+        std::size_t cleave{ 1 };
+        std::int32_t budgetJobs{ 0 };
+        std::int32_t budgetMicros{ 0 };
+        float lodMid{ 0.0f };
+        float lodFar{ 0.0f };
+        bool lodFarImpulse{ false };
+        bool attackEvents{ false };
+    };
+
+    struct SimActor
+    {
+        Vec3 position;
+        Vec3 velocity;
+        float currentLeft{ 0.0f };
+        std::uint32_t race{ 0 };
+        std::uint8_t ownKeywordFlags{ 0 };
+        bool dead{ false };
+        bool attacking{ false };
+        bool watched{ false };
+        bool loaded{ true };
+    };
+
+    class SimWorld final : public IWorld, public IAttackEventSource
+    {
+    public:
+        SimWorld(std::size_t actorCount, const Settings& settings, bool attackEvents, std::mt19937& rng) :
+            _rng(rng), _attackEvents(attackEvents)
+        {
+            _settings = std::make_shared<const Settings>(settings);
+
+            // A handful of races: humanoids allowed by keyword, a denied big race, one listed race.
+            constexpr std::uint32_t kRaces = 8;
+            std::vector<std::pair<std::uint32_t, std::uint8_t>> verdicts;
+            for (std::uint32_t r = 0; r < kRaces; ++r) {
+                std::uint8_t flags = kKeywordAllowed;
+                if (r == 6) flags = kKeywordDenied;
+                if (r == 7) flags = kListAllowed;
+                verdicts.emplace_back(0x13740 + r, flags);
+            }
+            _raceFlags = FlatMap<std::uint32_t, std::uint8_t>(std::move(verdicts));
+
+            std::uniform_real_distribution<float> pos(-kWorldExtent, kWorldExtent);
+            std::uniform_int_distribution<std::uint32_t> race(0, kRaces - 1);
+            std::bernoulli_distribution rare(0.02);
+
+            _actors.resize(actorCount);
+            for (auto& a : _actors) {
+                a.position = Vec3{ pos(_rng), pos(_rng), 0.0f };
+                a.race = 0x13740 + race(_rng);
+                a.dead = rare(_rng);
+                a.loaded = !rare(_rng);
+            }
+        }
+
+        SettingsPtr AcquireSettings() override { return _settings; }
+
+        bool GetActorState(ActorId id, ActorState& out) const override
+        {
+            const auto* a = Find(id);
+            if (!a) {
+                return false;
+            }
+            out.position = a->position;
+            out.dead = a->dead;
+            out.player = id == kPlayerId;
+            out.race = a->race;
+            return true;
+        }
+
+        bool IsAttacking(ActorId id) const override
+        {
+            const auto* a = Find(id);
+            return a && a->attacking;
+        }
+
+        IAttackEventSource* AttackEvents() override { return _attackEvents ? this : nullptr; }
+
+        bool Watch(ActorId id) override
+        {
+            auto* a = Find(id);
+            if (!a || !a->loaded) {
+                return false;
+            }
+            a->watched = true;
+            return true;
+        }
+
+        void Drain(std::vector<AttackEvent>& out) override
+        {
+            out.insert(out.end(), _events.begin(), _events.end());
+            _events.clear();
+        }
+
+        bool IsValidTarget(const Settings&, ActorId target) const override
+        {
+            const auto* a = Find(target);
+            if (!a) {
+                return false;
+            }
+
+            std::uint8_t flags = 0;
+            if (const auto* v = _raceFlags.find(a->race)) {
+                flags = *v;
+            }
+            if (flags & kListDenied) return false;
+            if (flags & kListAllowed) return true;
+
+            flags |= a->ownKeywordFlags;
+            if (flags & kKeywordDenied) return false;
+            return (flags & kKeywordAllowed) != 0;
+        }
+
+        bool SuppressedByFirstPerson(const Settings& settings, ActorId aggressor) const override
+        {
+            return settings.disableInFirstPerson && aggressor == kPlayerId && _firstPerson;
+        }
+
+        bool GetCameraPosition(Vec3& out) const override
+        {
+            const auto* player = Find(kPlayerId);
+            if (!player) {
+                return false;
+            }
+            out = player->position;
+            return true;
+        }
+
+        bool ApplyCurrent(ActorId target, const Vec3& velocity, float duration) override
+        {
+            auto* a = Find(target);
+            if (!a || !a->loaded) {
+                return false;
+            }
+            a->velocity = Vec3{ velocity.x * kHavokToSkyrim, velocity.y * kHavokToSkyrim, 0.0f };
+            a->currentLeft = duration;
+            ++_applyCurrentCalls;
+            return true;
+        }
+
+        bool AddTask(std::function<void()> fn) override
+        {
+            _tasks.push_back(std::move(fn));
+            return true;
+        }
+
+        // Stand-in for the game's own frame: integrate pushes, flip attack states.
+        void Step()
+        {
+            std::bernoulli_distribution toggleAttack(0.05);
+            for (ActorId id = 1; id <= _actors.size(); ++id) {
+                auto& a = _actors[id - 1];
+                if (a.currentLeft > 0.0f) {
+                    const float dt = std::min(kFrameSeconds, a.currentLeft);
+                    a.position.x += a.velocity.x * dt;
+                    a.position.y += a.velocity.y * dt;
+                    a.currentLeft -= dt;
+                }
+                if (toggleAttack(_rng)) {
+                    a.attacking = !a.attacking;
+                    if (a.watched) {
+                        _events.push_back(AttackEvent{ id, a.attacking ? AttackEventKind::kStart : AttackEventKind::kEnd });
+                    }
+                }
+            }
+        }
+
+        // Runs what the core queued (the scheduler tick); work queued meanwhile waits a frame.
+        void RunTasks()
+        {
+            _running.swap(_tasks);
+            for (auto& fn : _running) {
+                fn();
+            }
+            _running.clear();
+        }
+
+        std::size_t ActorCount() const { return _actors.size(); }
+        std::uint64_t ApplyCurrentCalls() const { return _applyCurrentCalls; }
+
+        static constexpr ActorId kPlayerId = 1;
+
+    private:
+        const SimActor* Find(ActorId id) const
+        {
+            return (id >= 1 && id <= _actors.size()) ? &_actors[id - 1] : nullptr;
+        }
+        SimActor* Find(ActorId id)
+        {
+            return (id >= 1 && id <= _actors.size()) ? &_actors[id - 1] : nullptr;
+        }
+
+        std::mt19937& _rng;
+        SettingsPtr _settings;
+        FlatMap<std::uint32_t, std::uint8_t> _raceFlags;
+        std::vector<SimActor> _actors;
+        std::vector<std::function<void()>> _tasks;
+        std::vector<std::function<void()>> _running;
+        std::vector<AttackEvent> _events;
+        std::uint64_t _applyCurrentCalls{ 0 };
+        bool _firstPerson{ false };
+        bool _attackEvents{ false };
+    };
+
+    bool ParseArgs(int argc, char** argv, Options& opts)
+    {
+        for (int i = 1; i < argc; ++i) {
+            const char* arg = argv[i];
+            const char* val = i + 1 < argc ? argv[i + 1] : nullptr;
+            if (!val) {
+                return false;
+            }
+
+            if (std::strcmp(arg, "--actors") == 0) opts.actors = std::strtoull(val, nullptr, 10);
+            else if (std::strcmp(arg, "--hits") == 0) opts.hitsPerFrame = std::strtoull(val, nullptr, 10);
+            else if (std::strcmp(arg, "--frames") == 0) opts.frames = std::strtoull(val, nullptr, 10);
+            else if (std::strcmp(arg, "--seed") == 0) opts.seed = static_cast<std::uint32_t>(std::strtoul(val, nullptr, 10));
+            else if (std::strcmp(arg, "--csv") == 0) opts.csvPath = val;
+            else if (std::strcmp(arg, "--trace") == 0) opts.tracePath = val;
+            else if (std::strcmp(arg, "--stats") == 0) opts.statsPath = val;
+            else if (std::strcmp(arg, "--capture") == 0) opts.capturePath = val;
+            else if (std::strcmp(arg, "--adaptive") == 0) opts.adaptive = std::strcmp(val, "0") != 0;
+            else if (std::strcmp(arg, "--cleave") == 0) opts.cleave = std::max<std::size_t>(1, std::strtoull(val, nullptr, 10));
+            else if (std::strcmp(arg, "--budget-jobs") == 0) opts.budgetJobs = std::max(0, std::atoi(val));
+            else if (std::strcmp(arg, "--budget-us") == 0) opts.budgetMicros = std::max(0, std::atoi(val));
+            else if (std::strcmp(arg, "--lod-mid") == 0) opts.lodMid = std::max(0.0f, std::strtof(val, nullptr));
+            else if (std::strcmp(arg, "--lod-far") == 0) opts.lodFar = std::max(0.0f, std::strtof(val, nullptr));
+            else if (std::strcmp(arg, "--lod-far-impulse") == 0) opts.lodFarImpulse = std::strcmp(val, "0") != 0;
+            else if (std::strcmp(arg, "--attack-events") == 0) opts.attackEvents = std::strcmp(val, "0") != 0;
+            else if (std::strcmp(arg, "--kernel-check") == 0) opts.kernelCheckLanes = std::strtoull(val, nullptr, 10);
+            else return false;
+            ++i;
+        }
+        return opts.actors >= 2 || opts.kernelCheckLanes > 0;
+    }
+
+    // Random lanes, including the edge cases: overlapping actors, zero durations,
+    // disabled shaping, separation lanes already past the minimum distance.
+    void FillRandomBatch(ShoveBatch& batch, std::size_t lanes, std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> pos(-kWorldExtent, kWorldExtent);
+        std::uniform_real_distribution<float> near(-200.0f, 200.0f);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::bernoulli_distribution coin(0.5);
+        std::bernoulli_distribution rare(0.05);
+
+        batch.clear();
+        for (std::size_t i = 0; i < lanes; ++i) {
+            const Vec3 a{ pos(rng), pos(rng), 0.0f };
+            Vec3 t{ a.x + near(rng), a.y + near(rng), 0.0f };
+            if (rare(rng)) {
+                t = a;
+            }
+
+            Settings s{};
+            s.shoveMagnitude = 1.0f + 4.0f * unit(rng);
+            s.shoveDuration = rare(rng) ? 0.0f : 0.05f + 0.2f * unit(rng);
+            s.applyCurrentMinVelocity = rare(rng) ? 0.0f : 2.0f + 6.0f * unit(rng);
+            s.minDurationScale = unit(rng);
+            s.minSeparationDistance = 50.0f + 150.0f * unit(rng);
+            s.separationPushDuration = rare(rng) ? 0.0f : 0.05f + 0.2f * unit(rng);
+            s.separationMaxVelocity = rare(rng) ? 0.0f : 5.0f + 10.0f * unit(rng);
+
+            if (coin(rng)) {
+                batch.AddSeparation(a, t, s);
+            }
+            else {
+                batch.AddShove(a, t, s, 2.0f * unit(rng));
+            }
+        }
+    }
+
+    float MaxRelDiff(const std::vector<float>& a, const std::vector<float>& b)
+    {
+        float worst = 0.0f;
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            const float scale = std::max({ 1.0f, std::fabs(a[i]), std::fabs(b[i]) });
+            worst = std::max(worst, std::fabs(a[i] - b[i]) / scale);
+        }
+        return worst;
+    }
+
+    int RunKernelCheck(std::size_t lanes, std::mt19937& rng)
+    {
+        ShoveBatch wide;
+        FillRandomBatch(wide, lanes, rng);
+        ShoveBatch scalar = wide;
+
+        constexpr int kRepeats = 200;
+        auto time = [&](ShoveBatch& b, void (*fn)(ShoveBatch&)) {
+            const auto start = std::chrono::steady_clock::now();
+            for (int r = 0; r < kRepeats; ++r) {
+                fn(b);
+            }
+            return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                   (static_cast<double>(kRepeats) * static_cast<double>(lanes));
+        };
+        const double wideNs = time(wide, ComputeShoveGeometry);
+        const double scalarNs = time(scalar, ComputeShoveGeometryScalar);
+
+        const float worst = std::max({ MaxRelDiff(wide.distance, scalar.distance), MaxRelDiff(wide.dirX, scalar.dirX),
+            MaxRelDiff(wide.dirY, scalar.dirY), MaxRelDiff(wide.magnitude, scalar.magnitude),
+            MaxRelDiff(wide.duration, scalar.duration) });
+
+        std::printf("kernel lanes=%zu width=%zu\n", lanes, ShoveKernelLanes());
+        std::printf("ns/pair: vector=%.2f scalar=%.2f speedup=%.2fx\n", wideNs, scalarNs, wideNs > 0.0 ? scalarNs / wideNs : 0.0);
+        std::printf("max relative difference vs scalar: %g\n", worst);
+
+        constexpr float kTolerance = 1e-6f;
+        if (worst > kTolerance) {
+            std::printf("MISMATCH (tolerance %g)\n", kTolerance);
+            return 1;
+        }
+        return 0;
+    }
+
+    double Percentile(std::vector<double> v, double p)
+    {
+        if (v.empty()) {
+            return 0.0;
+        }
+        const auto k = static_cast<std::size_t>(p * static_cast<double>(v.size() - 1));
+        std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(k), v.end());
+        return v[k];
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options opts{};
+    if (!ParseArgs(argc, argv, opts)) {
+        std::fprintf(stderr, "usage: %s [--actors N] [--hits H] [--frames F] [--seed S] [--csv out.csv] [--trace out.kblog] [--stats out.txt] [--capture out.kbcap] [--adaptive 0|1] [--cleave K] [--budget-jobs N] [--budget-us U] [--lod-mid D] [--lod-far D] [--lod-far-impulse 0|1] [--attack-events 0|1]\n", argv[0]);
+        return 2;
+    }
+
+    std::mt19937 rng(opts.seed);
+    if (opts.kernelCheckLanes > 0) {
+        return RunKernelCheck(opts.kernelCheckLanes, rng);
+    }
+
+    Settings settings{};
+    settings.adaptiveRetries = opts.adaptive;
+    settings.frameBudgetJobs = opts.budgetJobs;
+    settings.frameBudgetMicros = opts.budgetMicros;
+    settings.lodMidDistance = opts.lodMid;
+    settings.lodFarDistance = opts.lodFar;
+    settings.lodFarImpulse = opts.lodFarImpulse;
+    SimWorld world(opts.actors, settings, opts.attackEvents, rng);
+    SetWorld(world);
+    if (opts.capturePath && !Capture::Start(opts.capturePath, world)) {
+        return 1;
+    }
+
+    if (opts.tracePath) {
+        BinLog::Start(opts.tracePath);
+    }
+
+    std::FILE* csv = opts.csvPath ? std::fopen(opts.csvPath, "w") : nullptr;
+    if (csv) {
+        std::fprintf(csv, "frame,cpu_us,hits,pending_jobs,active_chains\n");
+    }
+
+    // Weapon table: a few configured multipliers plus an unconfigured (0) entry.
+    const float weaponMults[] = { 0.85f, 1.0f, 1.0f, 1.25f, 1.5f, 0.0f };
+    std::uniform_int_distribution<std::size_t> pickWeapon(0, std::size(weaponMults) - 1);
+    std::uniform_int_distribution<ActorId> pickActor(1, static_cast<ActorId>(world.ActorCount()));
+    std::bernoulli_distribution playerSwing(0.2);
+    std::bernoulli_distribution powerAttack(0.1);
+
+    std::vector<HitEvent> hits(opts.hitsPerFrame);
+    std::vector<double> frameMicros;
+    frameMicros.reserve(opts.frames);
+
+    std::size_t peakPending = 0;
+    std::size_t peakChains = 0;
+    // Heap allocations inside the timed region, over the whole run and over its second half.
+    std::uint64_t frameAllocations = 0;
+    std::uint64_t steadyAllocations = 0;
+
+    for (std::size_t frame = 0; frame < opts.frames; ++frame) {
+        world.Step();
+
+        // Generated outside the timed region: this is the game's side of the event.
+        for (auto& h : hits) {
+            h.aggressor = playerSwing(rng) ? SimWorld::kPlayerId : pickActor(rng);
+            do {
+                h.target = pickActor(rng);
+            } while (h.target == h.aggressor);
+            h.weaponMult = weaponMults[pickWeapon(rng)] * (powerAttack(rng) ? 1.2f : 1.0f);
+        }
+
+        // Cleaves: the swing's hit is followed by one hit per extra victim, as the game sends them.
+        if (opts.cleave > 1) {
+            for (std::size_t i = 0; i < hits.size(); ++i) {
+                if (hits[i].aggressor != SimWorld::kPlayerId) {
+                    continue;
+                }
+                const auto last = std::min(hits.size(), i + opts.cleave);
+                for (std::size_t k = i + 1; k < last; ++k) {
+                    hits[k].aggressor = hits[i].aggressor;
+                    hits[k].weaponMult = hits[i].weaponMult;
+                    while (hits[k].target == hits[k].aggressor) {
+                        hits[k].target = pickActor(rng);
+                    }
+                }
+                i = last - 1;
+            }
+        }
+
+        const auto allocsBefore = g_heapAllocations.load(std::memory_order_relaxed);
+        const auto start = std::chrono::steady_clock::now();
+        // Pinned from the sim world itself, like the game's drain pins its config snapshot.
+        const auto cfg = world.AcquireSettings();
+        Capture::RecordHits(hits, *cfg);
+        SubmitHits(cfg, hits);
+        world.RunTasks();
+        const auto micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        const auto allocs = g_heapAllocations.load(std::memory_order_relaxed) - allocsBefore;
+        frameAllocations += allocs;
+        if (frame >= opts.frames / 2) {
+            steadyAllocations += allocs;
+        }
+
+        frameMicros.push_back(micros);
+
+        const auto pending = GetPendingJobCount();
+        const auto chains = GetActiveShoveChainCount();
+        peakPending = std::max(peakPending, pending);
+        peakChains = std::max(peakChains, chains);
+
+        if (csv) {
+            std::fprintf(csv, "%zu,%.3f,%zu,%zu,%zu\n", frame, micros, hits.size(), pending, chains);
+        }
+    }
+
+    if (csv) {
+        std::fclose(csv);
+    }
+    if (opts.tracePath) {
+        BinLog::Stop();
+    }
+    Capture::Stop();
+    if (opts.statsPath) {
+        if (std::FILE* stats = std::fopen(opts.statsPath, "w")) {
+            const auto text = Metrics::Format(Metrics::Collect(), nullptr) + Adaptive::FormatTable();
+            std::fwrite(text.data(), 1, text.size(), stats);
+            std::fclose(stats);
+        }
+    }
+
+    double total = 0.0;
+    for (const auto us : frameMicros) {
+        total += us;
+    }
+    const double mean = frameMicros.empty() ? 0.0 : total / static_cast<double>(frameMicros.size());
+    const double totalHits = static_cast<double>(opts.hitsPerFrame * opts.frames);
+
+    std::printf("actors=%zu hits/frame=%zu frames=%zu seed=%u\n", opts.actors, opts.hitsPerFrame, opts.frames, opts.seed);
+    std::printf("frame cpu us: mean=%.2f p50=%.2f p99=%.2f max=%.2f\n",
+        mean, Percentile(frameMicros, 0.50), Percentile(frameMicros, 0.99),
+        frameMicros.empty() ? 0.0 : *std::max_element(frameMicros.begin(), frameMicros.end()));
+    std::printf("per hit ns (amortized, incl. jobs): %.1f\n", totalHits > 0.0 ? total * 1000.0 / totalHits : 0.0);
+    std::printf("applyCurrent=%llu peakPendingJobs=%zu peakActiveChains=%zu\n",
+        static_cast<unsigned long long>(world.ApplyCurrentCalls()), peakPending, peakChains);
+    const auto pool = GetJobPoolStats();
+    std::printf("job pool: highWater=%zu capacity=%zu chunks=%zu\n", pool.highWater, pool.capacity, pool.chunks);
+    std::printf("heap allocations in frames: total=%llu second half=%llu\n",
+        static_cast<unsigned long long>(frameAllocations), static_cast<unsigned long long>(steadyAllocations));
+    return 0;
+}
@@ -0,0 +1,190 @@
+// KnockbackWatcherCheck
+// Runs ConfigWatcher against files in a temporary directory and checks the two behaviours
+// the config reload depends on:
+//   burst     - a file rewritten many times in quick succession (an editor saving in
+//               several steps) is reported once, after the writes settle;
+//   late-dir  - a file whose directory does not exist when the watcher starts (no
+//               notification handle can be opened for it) is still picked up by polling
+//               once the directory and file are created.
+//
+//   KnockbackWatcherCheck [--dir D] [--no-notify]
+//
+// Exits non-zero if either check fails.
+
+#include <Knockback/ConfigWatcher.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Knockback;
+using namespace std::chrono_literals;
+namespace fs = std::filesystem;
+
+struct Options
+{
+    fs::path dir{ fs::temp_directory_path() / "KnockbackWatcherCheck" };
+    bool notify{ true };
+};
+
+static bool ParseArgs(int argc, char** argv, Options& opts)
+{
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (std::strcmp(arg, "--no-notify") == 0) {
+            opts.notify = false;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const char* value = argv[++i];
+        if (std::strcmp(arg, "--dir") == 0) {
+            opts.dir = value;
+        }
+        else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Collects callbacks from the watcher thread.
+class Recorder
+{
+public:
+    void operator()(std::uint32_t mask)
+    {
+        std::scoped_lock lock(_mutex);
+        _masks.push_back(mask);
+        _cv.notify_all();
+    }
+
+    // Waits until at least count callbacks arrived or the timeout passed.
+    bool WaitFor(std::size_t count, std::chrono::milliseconds timeout)
+    {
+        std::unique_lock lock(_mutex);
+        return _cv.wait_for(lock, timeout, [&] { return _masks.size() >= count; });
+    }
+
+    std::vector<std::uint32_t> Masks()
+    {
+        std::scoped_lock lock(_mutex);
+        return _masks;
+    }
+
+private:
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::vector<std::uint32_t> _masks;
+};
+
+static void WriteFile(const fs::path& path, int generation)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << "[General]\n";
+    // Grows every time so the size changes even where timestamps are coarse.
+    for (int i = 0; i <= generation; ++i) {
+        out << "fMultiplier" << i << " = 1.0\n";
+    }
+}
+
+static bool Report(const char* name, bool ok, const std::vector<std::uint32_t>& masks)
+{
+    std::printf("%-8s %s callbacks=%zu", name, ok ? "ok  " : "FAIL", masks.size());
+    for (const auto mask : masks) {
+        std::printf(" 0x%x", mask);
+    }
+    std::printf("\n");
+    return ok;
+}
+
+// Twenty rewrites 20 ms apart against a 200 ms debounce: one callback, for file 0 only.
+static bool CheckBurst(const Options& opts)
+{
+    const auto watched = opts.dir / "burst.ini";
+    const auto other = opts.dir / "untouched.ini";
+    WriteFile(watched, 0);
+    WriteFile(other, 0);
+
+    Recorder recorder;
+    ConfigWatcher::Options wopts{};
+    wopts.pollInterval = 100ms;
+    wopts.debounce = 200ms;
+    wopts.useNotifications = opts.notify;
+
+    ConfigWatcher watcher({ watched, other }, std::ref(recorder), wopts);
+    watcher.Start();
+    // Let the watcher take its baseline before the first write.
+    std::this_thread::sleep_for(150ms);
+
+    for (int i = 1; i <= 20; ++i) {
+        WriteFile(watched, i);
+        std::this_thread::sleep_for(20ms);
+    }
+
+    const bool fired = recorder.WaitFor(1, 2000ms);
+    // Anything still to come would arrive within another debounce window.
+    std::this_thread::sleep_for(600ms);
+    watcher.Stop();
+
+    const auto masks = recorder.Masks();
+    return Report("burst", fired && masks.size() == 1 && masks[0] == 1u, masks);
+}
+
+// The directory is created after Start, so the watcher has nothing to subscribe to and must
+// find the file through its stat() sweep.
+static bool CheckLateDirectory(const Options& opts)
+{
+    const auto lateDir = opts.dir / "late";
+    const auto watched = lateDir / "late.ini";
+
+    Recorder recorder;
+    ConfigWatcher::Options wopts{};
+    wopts.pollInterval = 200ms;
+    wopts.debounce = 100ms;
+    wopts.useNotifications = opts.notify;
+
+    ConfigWatcher watcher({ watched }, std::ref(recorder), wopts);
+    watcher.Start();
+    std::this_thread::sleep_for(300ms);
+
+    fs::create_directories(lateDir);
+    WriteFile(watched, 0);
+
+    // Worst case: a full poll interval to notice, one more sweep to see it settled, then the
+    // debounce.
+    const bool fired = recorder.WaitFor(1, 2000ms);
+    watcher.Stop();
+
+    const auto masks = recorder.Masks();
+    return Report("late-dir", fired && masks.size() == 1 && masks[0] == 1u, masks);
+}
+
+int main(int argc, char** argv)
+{
+    Options opts{};
+    if (!ParseArgs(argc, argv, opts)) {
+        std::fprintf(stderr, "usage: %s [--dir D] [--no-notify]\n", argv[0]);
+        return 2;
+    }
+
+    std::error_code ec;
+    fs::remove_all(opts.dir, ec);
+    fs::create_directories(opts.dir);
+    std::printf("dir %s, notifications %s\n", opts.dir.string().c_str(), opts.notify ? "on" : "off");
+
+    const bool burst = CheckBurst(opts);
+    const bool lateDir = CheckLateDirectory(opts);
+
+    fs::remove_all(opts.dir, ec);
+    return burst && lateDir ? 0 : 1;
+}